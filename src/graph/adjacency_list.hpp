@@ -1,32 +1,58 @@
 #ifndef GRAPH_ADJACENCY_LIST_HPP
 #define GRAPH_ADJACENCY_LIST_HPP
 
+#include "instrumentation.hpp"
 #include "tags.hpp"
 #include "traits.hpp"
+#include "memory_usage.hpp"
 #include "properties.hpp"
+#include "storage.hpp"
 
 #include <boost/iterator/counting_iterator.hpp>
 #include <boost/iterator/filter_iterator.hpp>
 #include <boost/iterator/iterator_adaptor.hpp>
 
 #include <cassert>
+#include <cstddef>
 #include <list>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 namespace graph {
 
+/**
+ * @tparam Allocator allocator rebound for the vertex list, the edge list, the edge properties
+ * 			and the adjacency list of every vertex, e.g. std::pmr::polymorphic_allocator<std::byte>
+ * 			(see graph::pmr::AdjacencyList) to place the whole graph in one memory resource.
+ * @tparam StoragePolicy container of the out and in edge lists of every vertex,
+ * 			VectorStorage or SmallStorage<N> (see storage.hpp).
+ */
 template<typename DirectedCategoryT,
          typename VertexPropT = NoProp,
-         typename EdgePropT = NoProp>
+         typename EdgePropT = NoProp,
+         typename Allocator = std::allocator<std::byte>,
+         typename StoragePolicy = VectorStorage>
 struct AdjacencyList {
 private:
+	template<typename T>
+	using Alloc = typename std::allocator_traits<Allocator>::template rebind_alloc<T>;
+
+	// Tag selecting the StoredVertex constructors taking the allocator for the edge lists.
+	// std::allocator_arg_t is not used as it would trigger uses-allocator construction.
+	struct WithAllocator {};
+
 	/**
 	 * @brief object to hold an index to the stored edge in the global storedEdgeList.
 	 * 			Represents an out edge of a vertex.
 	 */
 	struct OutEdge {
 		OutEdge (std::size_t storedEdgeIdx) : storedEdgeIdx(storedEdgeIdx) {}
-		const std::size_t storedEdgeIdx;
+		std::size_t storedEdgeIdx;
 	};
 
 	/**
@@ -38,14 +64,23 @@ private:
 		std::size_t storedEdgeIdx;
 	};
 
-	using InEdgeList = std::vector<InEdge>;
-	using OutEdgeList = std::vector<OutEdge>;
+	using InEdgeList = typename StoragePolicy::template List<InEdge, Alloc<InEdge>>;
+	using OutEdgeList = typename StoragePolicy::template List<OutEdge, Alloc<OutEdge>>;
+
+	// The allocator of an edge list, made from the allocator of the graph.
+	// Edge lists of a storage policy may wrap the allocator (e.g. small_vector), so convert explicitly.
+	template<typename List>
+	static typename List::allocator_type listAllocator(const Allocator& a) {
+		return typename List::allocator_type(Alloc<typename List::value_type>(a));
+	}
 
 	/**
 	 * @brief StoredVertex object used when DirectedCategoryT is not bidirectional and VertexPropT is NoProp
 	 * 		Holds a list of outEdge objects
+	 * 		Every StoredVertex is constructed with the allocator of the graph, which its edge lists use.
 	 */
 	struct StoredVertexSimple {
+		StoredVertexSimple(WithAllocator, const Allocator& a) : eOut(listAllocator<OutEdgeList>(a)) {}
 		OutEdgeList eOut;
 	};
 
@@ -55,8 +90,8 @@ private:
 	 */
 	struct StoredVertexSimpleProp {
 		OutEdgeList eOut;
-		StoredVertexSimpleProp() = default;
-		StoredVertexSimpleProp(VertexPropT vp) : vProp(vp){}
+		StoredVertexSimpleProp(WithAllocator, const Allocator& a) : eOut(listAllocator<OutEdgeList>(a)), vProp() {}
+		StoredVertexSimpleProp(WithAllocator, const Allocator& a, VertexPropT vp) : eOut(listAllocator<OutEdgeList>(a)), vProp(vp){}
 		VertexPropT vProp;
 	};
 
@@ -65,6 +100,7 @@ private:
 	 * 		Holds a list of outEdge objects and a list of inEdge object
 	 */
 	struct StoredVertexComplex {
+		StoredVertexComplex(WithAllocator, const Allocator& a) : eOut(listAllocator<OutEdgeList>(a)), eIn(listAllocator<InEdgeList>(a)) {}
 		OutEdgeList eOut;
 		InEdgeList eIn;
 	};
@@ -77,8 +113,8 @@ private:
 	struct StoredVertexComplexProp {
 		OutEdgeList eOut;
 		InEdgeList eIn;
-		StoredVertexComplexProp() = default;
-		StoredVertexComplexProp(VertexPropT vp) : vProp(vp) {}
+		StoredVertexComplexProp(WithAllocator, const Allocator& a) : eOut(listAllocator<OutEdgeList>(a)), eIn(listAllocator<InEdgeList>(a)), vProp() {}
+		StoredVertexComplexProp(WithAllocator, const Allocator& a, VertexPropT vp) : eOut(listAllocator<OutEdgeList>(a)), eIn(listAllocator<InEdgeList>(a)), vProp(vp) {}
 		VertexPropT vProp;
 	};
 
@@ -95,39 +131,20 @@ private:
 
 
 	/**
-	 * @brief Stored Edge object where EdgePropT is NoProp
-	 * 			Holds a source and target number corresponding to the source and target vertex.
-	 */
-	struct StoredEdgeNoProp {
-		StoredEdgeNoProp() = default;
-		StoredEdgeNoProp(std::size_t src, std::size_t tar) : src(src), tar(tar) {}
-		std::size_t src, tar;
-	};
-
-	/**
-	 * @brief Stored Edge object where EdgePropT is not NoProp
-	 * 			Holds a source and target number corresponding to the source and target vertex.
-	 * 			Also holds EdgePropT along with the edge
+	 * @brief Stored Edge object holding a source and target number corresponding to the source and target vertex.
+	 * 			The EdgePropT of the edge is not stored here but at the same index in the ePropList,
+	 * 			so walking the topology does not pull the properties through the cache.
 	 */
-	struct StoredEdgeProp {
-		StoredEdgeProp() = default;
-		StoredEdgeProp(std::size_t src, std::size_t tar) : src(src), tar(tar) {}
-		StoredEdgeProp(std::size_t src, std::size_t tar, EdgePropT ep) : eProp(ep), src(src), tar(tar) {}
-
-		EdgePropT eProp;
+	struct StoredEdge {
+		StoredEdge() = default;
+		StoredEdge(std::size_t src, std::size_t tar) : src(src), tar(tar) {}
 		std::size_t src, tar;
 	};
 
-	/**
-	 * @brief conditional determining which StoredEdge object to use.
-	 * 			If the EdgePropT type parameter is NoProp it uses the StoredEdgeNoProp object, StoredEdgeProp otherwise.
-	 * 			The result is used in the StoredEdge which is used in all member functions
-	 */
-	typedef std::conditional<std::is_same<EdgePropT, graph::NoProp>::value, StoredEdgeNoProp, StoredEdgeProp>::type StoredEdgePropType;
-	using StoredEdge = StoredEdgePropType;
-
-	using VList = std::vector<StoredVertex>;
-	using EList = std::vector<StoredEdge>;
+	using VList = std::vector<StoredVertex, Alloc<StoredVertex>>;
+	using EList = std::vector<StoredEdge, Alloc<StoredEdge>>;
+	// stays empty when EdgePropT is NoProp
+	using EPropList = std::vector<EdgePropT, Alloc<EdgePropT>>;
 public: // Graph
 	using DirectedCategory = DirectedCategoryT;
 	using VertexDescriptor = std::size_t;
@@ -237,7 +254,7 @@ public: // IncidenceGraph Associated types
 				// 		variable to access the edge in the StoredEdge list from g.
 				//		return the edge descriptor matching the StoredEdge found on the index.
 				const OEListIterator& i = this->base_reference();
-				StoredEdge e = g->eList[i->storedEdgeIdx];
+				const StoredEdge& e = g->eList[i->storedEdgeIdx];
 				return EdgeDescriptor(e.src, e.tar, i->storedEdgeIdx);
 			}
 		private:
@@ -257,7 +274,7 @@ public: // IncidenceGraph Associated types
 			return iterator(g->vList[idx].eOut.end(), g->vList[idx].eOut.begin(), g);
 		}
 	private:
-		const VertexDescriptor& v;
+		VertexDescriptor v;
 		const AdjacencyList* g;
 	};
 
@@ -292,7 +309,7 @@ public: // BidirectionalGraph
 				// 		variable to access the edge in the StoredEdge list from g.
 				//		return the edge descriptor matching the StoredEdge found on the index.
 				const IEListIterator& i = this->base_reference();
-				StoredEdge e = g->eList[i->storedEdgeIdx];
+				const StoredEdge& e = g->eList[i->storedEdgeIdx];
 				return EdgeDescriptor(e.src, e.tar, i->storedEdgeIdx);
 			}
 		private:
@@ -312,18 +329,43 @@ public: // BidirectionalGraph
 			return iterator(g->vList[idx].eIn.end(), g->vList[idx].eIn.begin(), g);
 		}
 	private:
-		const VertexDescriptor& v;
+		VertexDescriptor v;
 		const AdjacencyList* g;
 	};
 public:
+	using allocator_type = Allocator;
+
 	AdjacencyList() = default;
-	AdjacencyList(std::size_t n) : vList(n) {}
+	explicit AdjacencyList(const Allocator& alloc) : vList(alloc), eList(alloc), ePropList(alloc) {}
+
+	AdjacencyList(std::size_t n, const Allocator& alloc = Allocator())
+		: vList(alloc), eList(alloc), ePropList(alloc) {
+		vList.reserve(n);
+		for(std::size_t i = 0; i < n; ++i)
+			vList.emplace_back(WithAllocator{}, alloc);
+	}
 
 	//* Copy constructor
-	AdjacencyList(const AdjacencyList& a) : vList(a.vList), eList(a.eList) {}
+	AdjacencyList(const AdjacencyList& a) : vList(a.vList), eList(a.eList), ePropList(a.ePropList) {}
+
+	Allocator get_allocator() const { return Allocator(vList.get_allocator()); }
+private:
+	/**
+	 * @brief Appends a new edge to the eList and, unless EdgePropT is NoProp, its property to the ePropList.
+	 * 			The property is constructed from `ep`, or value initialised if `ep` is empty.
+	 * @return the index of the new stored edge
+	 */
+	template<typename... EP>
+	std::size_t pushStoredEdge(std::size_t src, std::size_t tar, EP&&... ep) {
+		eList.push_back(StoredEdge(src, tar));
+		if constexpr(!std::is_same<EdgePropT, graph::NoProp>::value)
+			ePropList.emplace_back(std::forward<EP>(ep)...);
+		return eList.size() - 1;
+	}
 private:
 	VList vList;
 	EList eList;
+	EPropList ePropList;
 public: // Graph
 	friend VertexDescriptor source(EdgeDescriptor e, const AdjacencyList &g) {
 		return e.src;
@@ -372,6 +414,23 @@ public: // IncidenceGraph Valid Expressions
 		return std::distance(oe.begin(), oe.end());
 	}
 
+	/**
+	 * @brief Scans the out edges of `src`, so the cost is O(outDegree(src, g)).
+	 * 			Use an EdgeIndex (edge_index.hpp) for repeated lookups on high-degree vertices.
+	 *
+	 * @param src vertex descriptor of the source vertex
+	 * @param tar vertex descriptor of the target vertex
+	 * @param g graph which the vertices belong to
+	 * @return the first added edge from `src` to `tar`, or std::nullopt if there is none.
+	 */
+	friend std::optional<EdgeDescriptor> edge(VertexDescriptor src, VertexDescriptor tar, const AdjacencyList& g) {
+		for(const OutEdge& oe : g.vList[getIndex(src, g)].eOut) {
+			if(g.eList[oe.storedEdgeIdx].tar == tar)
+				return EdgeDescriptor(src, tar, oe.storedEdgeIdx);
+		}
+		return std::nullopt;
+	}
+
 public: // BidirectionalGraph
 	/**
 	 * @brief The DirectedCategory of the graph must be Bidirectional
@@ -409,7 +468,7 @@ public: // MutableGraph
 	friend VertexDescriptor addVertex(AdjacencyList& g)
 	requires( std::is_default_constructible<VertexProp>::value ) {
 		VertexDescriptor newV = numVertices(g);
-		g.vList.push_back(StoredVertex());
+		g.vList.emplace_back(WithAllocator{}, g.get_allocator());
 		return newV;
 	}
 
@@ -425,8 +484,7 @@ public: // MutableGraph
 	friend EdgeDescriptor addEdge(VertexDescriptor v, VertexDescriptor u,  AdjacencyList& g)
 	requires(std::same_as<DirectedCategory, graph::tags::Directed>
 	&& std::is_default_constructible<EdgeProp>::value) {
-		std::size_t index = numEdges(g);
-		g.eList.push_back(StoredEdge(v,u));
+		std::size_t index = g.pushStoredEdge(v, u);
 		EdgeDescriptor newEdge (v, u, index);
 
 		// Add outedge to `v`
@@ -448,8 +506,7 @@ public: // MutableGraph
 	friend EdgeDescriptor addEdge(VertexDescriptor v, VertexDescriptor u,  AdjacencyList& g)
 	requires(std::same_as<DirectedCategory, graph::tags::Bidirectional>
 	&& std::is_default_constructible<EdgeProp>::value) {
-		std::size_t index = numEdges(g);
-		g.eList.push_back(StoredEdge(v,u));
+		std::size_t index = g.pushStoredEdge(v, u);
 		EdgeDescriptor newEdge (v, u, index);
 
 		// Add outedge to `v`
@@ -478,7 +535,7 @@ public: // MutablePropertyGraph
 	requires( !std::same_as<VertexProp, graph::NoProp> &&
 	std::movable<VertexProp>) {
 		VertexDescriptor newV = numVertices(g);
-		g.vList.push_back(StoredVertex(vp));
+		g.vList.emplace_back(WithAllocator{}, g.get_allocator(), std::move(vp));
 		return newV;
 	}
 
@@ -496,8 +553,7 @@ public: // MutablePropertyGraph
 	requires (!std::same_as<EdgeProp, graph::NoProp> &&
 	std::movable<EdgeProp> &&
 	std::same_as<DirectedCategory, graph::tags::Directed>) {
-		std::size_t index = numEdges(g);
-		g.eList.push_back(StoredEdge(v,u,ep));
+		std::size_t index = g.pushStoredEdge(v, u, std::move(ep));
 		EdgeDescriptor newEdge (v, u, index);
 
 		// Add outedge to `v`
@@ -521,8 +577,7 @@ public: // MutablePropertyGraph
 	requires (!std::same_as<EdgeProp, graph::NoProp> &&
 	std::movable<EdgeProp> &&
 	std::same_as<DirectedCategory, graph::tags::Bidirectional>) {
-		std::size_t index = numEdges(g);
-		g.eList.push_back(StoredEdge(v,u,ep));
+		std::size_t index = g.pushStoredEdge(v, u, std::move(ep));
 		EdgeDescriptor newEdge (v, u, index);
 
 		// Add outedge to `v`
@@ -538,6 +593,99 @@ public: // MutablePropertyGraph
 		return newEdge;
 	}
 
+public: // Bulk construction
+	/**
+	 * @brief Bulk version of addEdge. The degrees of the endpoints are counted first so every
+	 * 			adjacency list and the edge list grow at most once.
+	 * 			If the elements are pairs the EdgePropT type parameter must be default constructible,
+	 * 			if they are triples the third element is copied as the EdgeProp.
+	 *
+	 * @param es forward range of std::pair(src, tar) or std::tuple(src, tar, EdgeProp)
+	 * @param g graph to add the edges to.
+	 */
+	template<std::ranges::forward_range EdgePairRange>
+	friend void addEdges(const EdgePairRange& es, AdjacencyList& g) {
+		GRAPH_PHASE("addEdges");
+		using Elem = std::ranges::range_value_t<EdgePairRange>;
+		constexpr bool withProp = std::tuple_size_v<Elem> == 3;
+		static_assert(withProp || std::is_default_constructible<EdgeProp>::value);
+		constexpr bool withInEdges = std::same_as<DirectedCategory, graph::tags::Bidirectional>;
+
+		std::vector<std::size_t> outCount(numVertices(g)), inCount;
+		if constexpr(withInEdges)
+			inCount.resize(numVertices(g));
+		std::size_t m = 0;
+		for(const auto& x : es) {
+			++outCount[getIndex(std::get<0>(x), g)];
+			if constexpr(withInEdges)
+				++inCount[getIndex(std::get<1>(x), g)];
+			++m;
+		}
+		g.eList.reserve(g.eList.size() + m);
+		if constexpr(!std::is_same<EdgePropT, graph::NoProp>::value)
+			g.ePropList.reserve(g.ePropList.size() + m);
+		for(std::size_t i = 0; i < numVertices(g); ++i) {
+			g.vList[i].eOut.reserve(g.vList[i].eOut.size() + outCount[i]);
+			if constexpr(withInEdges)
+				g.vList[i].eIn.reserve(g.vList[i].eIn.size() + inCount[i]);
+		}
+
+		for(const auto& x : es) {
+			std::size_t index;
+			if constexpr(withProp)
+				index = g.pushStoredEdge(std::get<0>(x), std::get<1>(x), std::get<2>(x));
+			else
+				index = g.pushStoredEdge(std::get<0>(x), std::get<1>(x));
+			g.vList[getIndex(std::get<0>(x), g)].eOut.push_back(OutEdge(index));
+			if constexpr(withInEdges)
+				g.vList[getIndex(std::get<1>(x), g)].eIn.push_back(InEdge(index));
+		}
+	}
+
+public: // Memory
+	/**
+	 * @brief The vertex properties are counted as properties, the rest of each stored vertex
+	 * 			(edge list headers and inline edges) as vertex array. Adjacency entries are the
+	 * 			edge lists' heap blocks, so they are zero for vertices whose edges fit inline.
+	 *
+	 * @return MemoryUsage breakdown of the heap memory of `g`
+	 */
+	friend MemoryUsage memoryUsage(const AdjacencyList& g) {
+		constexpr std::size_t vPropSize = std::is_same<VertexPropT, graph::NoProp>::value ? 0 : sizeof(VertexPropT);
+		MemoryUsage usage;
+		usage.vertexArray = g.vList.size() * (sizeof(StoredVertex) - vPropSize);
+		usage.edgeArray = detail::usedBytes(g.eList);
+		usage.properties = g.vList.size() * vPropSize + detail::usedBytes(g.ePropList);
+		usage.slack = detail::slackBytes(g.vList) + detail::slackBytes(g.eList) + detail::slackBytes(g.ePropList);
+		auto addList = [&](const auto& list) {
+			const std::size_t capacity = StoragePolicy::heapCapacity(list);
+			const std::size_t size = capacity ? detail::usedBytes(list) : 0;
+			usage.adjacencySize += size;
+			usage.adjacencyCapacity += capacity;
+			usage.slack += capacity - size;
+		};
+		for(const StoredVertex& sv : g.vList) {
+			addList(sv.eOut);
+			if constexpr(std::same_as<DirectedCategory, graph::tags::Bidirectional>)
+				addList(sv.eIn);
+		}
+		return usage;
+	}
+
+	/**
+	 * @brief Releases the unused capacity of every container of `g`, e.g. after bulk building.
+	 */
+	friend void shrinkToFit(AdjacencyList& g) {
+		g.vList.shrink_to_fit();
+		g.eList.shrink_to_fit();
+		g.ePropList.shrink_to_fit();
+		for(StoredVertex& sv : g.vList) {
+			sv.eOut.shrink_to_fit();
+			if constexpr(std::same_as<DirectedCategory, graph::tags::Bidirectional>)
+				sv.eIn.shrink_to_fit();
+		}
+	}
+
 public: // PropertyGraph
 
 	/**
@@ -564,7 +712,7 @@ public: // PropertyGraph
 	 * @return EdgeProp& of the edgeprop stored at the edge
 	 */
 	EdgeProp& operator[] (EdgeDescriptor e) requires (!std::same_as<EdgeProp, graph::NoProp>) {
-		return eList[e.storedEdgeIdx].eProp;
+		return ePropList[e.storedEdgeIdx];
 	}
 
 	/**
@@ -573,10 +721,22 @@ public: // PropertyGraph
 	 * @return const EdgeProp& of the edgeprop stored at the edge
 	 */
 	const EdgeProp& operator[] (EdgeDescriptor e) const requires (!std::same_as<EdgeProp, graph::NoProp>) {
-		return eList[e.storedEdgeIdx].eProp;
+		return ePropList[e.storedEdgeIdx];
 	}
 };
 
+namespace pmr {
+
+// AdjacencyList whose storage all comes from one std::pmr::memory_resource, e.g. a GraphArena.
+template<typename DirectedCategoryT,
+         typename VertexPropT = NoProp,
+         typename EdgePropT = NoProp,
+         typename StoragePolicy = VectorStorage>
+using AdjacencyList = graph::AdjacencyList<DirectedCategoryT, VertexPropT, EdgePropT,
+                                           std::pmr::polymorphic_allocator<std::byte>, StoragePolicy>;
+
+} // namespace pmr
+
 } // namespace graph
 
 #endif // GRAPH_ADJACENCY_LIST_HPP
@@ -1,41 +1,99 @@
 #ifndef GRAPH_ADJACENCY_MATRIX_HPP
 #define GRAPH_ADJACENCY_MATRIX_HPP
 
+#include "instrumentation.hpp"
 #include "tags.hpp"
 #include "traits.hpp"
+#include "memory_usage.hpp"
 #include "properties.hpp"
 
 #include <boost/iterator/counting_iterator.hpp>
-#include <boost/iterator/filter_iterator.hpp>
-#include <boost/iterator/iterator_adaptor.hpp>
+#include <boost/iterator/iterator_facade.hpp>
 
+#include <algorithm>
+#include <bit>
 #include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <optional>
+#include <ranges>
 #include <tuple>
+#include <type_traits>
 #include <vector>
 
 namespace graph {
 
+/**
+ * @brief Dense graph storing which edges exist in a bitmap with one bit per cell, row-major
+ * 			for the out-edges and column-major for the in-edges, so existence checks and
+ * 			edge scans only touch bits. Edge properties live in a separate dense array of
+ * 			n * n entries, vertex properties in an array of n entries.
+ *
+ * @tparam VertexPropT property stored with each vertex, NoProp for none
+ * @tparam EdgePropT property stored with each edge, NoProp for none
+ */
+template<typename VertexPropT = NoProp, typename EdgePropT = NoProp>
 struct AdjacencyMatrix {
 private:
-	struct StoredEdge {
-		bool exists = false;
-	};
-	using Matrix = std::vector<StoredEdge>;
-	using MatrixIterator = typename Matrix::const_iterator;
+	using Word = std::uint64_t;
+	static constexpr std::size_t wordBits = 64;
+	static constexpr bool hasVProp = !std::is_same_v<VertexPropT, NoProp>;
+	static constexpr bool hasEProp = !std::is_same_v<EdgePropT, NoProp>;
 public: // Graph
 	using VertexDescriptor = std::size_t;
 
 	struct EdgeDescriptor {
 		std::size_t src, tar;
-		bool exists; // so we can represent both edges and non-edges
 	public:
 		friend bool operator==(const EdgeDescriptor &a, const EdgeDescriptor &b) {
-			return std::tie(a.src, a.tar, a.exists)
-				== std::tie(b.src, b.tar, b.exists);
+			return std::tie(a.src, a.tar) == std::tie(b.src, b.tar);
 		}
 	};
 
-	using DirectedCategory = tags::Directed;
+	using DirectedCategory = tags::Bidirectional;
+public: // PropertyGraph
+	using VertexProp = VertexPropT;
+	using EdgeProp = EdgePropT;
+private:
+	// Scans the bitmap of one row (or column when Transposed), jumping from one set bit to
+	// the next, so the cost is one word per 64 vertices plus one step per edge.
+	template<bool Transposed>
+	struct BitIterator : boost::iterator_facade<
+			BitIterator<Transposed>, EdgeDescriptor, std::forward_iterator_tag, EdgeDescriptor> {
+		BitIterator() = default;
+		BitIterator(const Word *words, std::size_t wordIdx, std::size_t numWords, std::size_t fixed)
+			: words(words), wordIdx(wordIdx), numWords(numWords), fixed(fixed) {
+			if(wordIdx != numWords) {
+				cur = words[wordIdx];
+				skipEmpty();
+			}
+		}
+	private:
+		friend class boost::iterator_core_access;
+
+		EdgeDescriptor dereference() const {
+			const std::size_t pos = wordIdx * wordBits + std::countr_zero(cur);
+			if constexpr(Transposed) return EdgeDescriptor{pos, fixed};
+			else return EdgeDescriptor{fixed, pos};
+		}
+
+		bool equal(const BitIterator &other) const {
+			return wordIdx == other.wordIdx && cur == other.cur;
+		}
+
+		void increment() {
+			cur &= cur - 1; // clear the lowest set bit
+			skipEmpty();
+		}
+
+		void skipEmpty() {
+			while(cur == 0 && ++wordIdx != numWords) cur = words[wordIdx];
+		}
+	private:
+		const Word *words = nullptr;
+		std::size_t wordIdx = 0, numWords = 0, fixed = 0;
+		Word cur = 0;
+	};
 public: // VertexList
 	struct VertexRange {
 		// the iterator is simply a counter that returns its value when dereferenced
@@ -49,122 +107,167 @@ public: // VertexList
 	};
 public: // EdgeList
 	struct EdgeRange {
-		// In the iterator, we want first adapt the MatrixIterator
-		// (which iterates through StoredEdges) to give EdgeDescirptors,
-		// and then skip those that don't exist in the graph.
-		// First: adapt the iterator for the matrix (which is a vector::iterator).
-		struct MatrixAdaptorIterator : boost::iterator_adaptor<
-				MatrixAdaptorIterator, // because we use CRTP
-				MatrixIterator, // the iterator we adapt
-				// we want to convert the StoredEdge into an EdgeDescriptor:
-				EdgeDescriptor, 
-				// we can use RA as the underlying iterator supports it:
-				std::random_access_iterator_tag, 
-				// when we dereference we return by value, not by reference:
-				EdgeDescriptor 
-		> {
-			using Base = boost::iterator_adaptor<
-				MatrixAdaptorIterator, MatrixIterator, EdgeDescriptor,
-				std::random_access_iterator_tag, EdgeDescriptor>;
-		public:
-			MatrixAdaptorIterator(const MatrixIterator &i,
-			                      const MatrixIterator &first,
-			                      std::size_t n)
-				: Base(i), first(first), n(n) {}
+		// Walks the row bitmaps in order, so the edges come out in row-major order.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor, std::forward_iterator_tag, EdgeDescriptor> {
+			iterator() = default;
+			iterator(const AdjacencyMatrix *g, std::size_t src) : g(g), src(src) {
+				if(src != g->n && g->usedWords() != 0) {
+					cur = g->row(src)[0];
+					skipEmpty();
+				} else {
+					this->src = g->n;
+				}
+			}
 		private:
-			// let the Boost machinery use our methods
-			friend class boost::iterator_core_access; 
+			friend class boost::iterator_core_access;
 
 			EdgeDescriptor dereference() const {
-				// get our current position stored in the
-				// boost::iterator_adaptor base class
-				const MatrixIterator &i = this->base_reference();
-				const auto idx = i - first;
-				// then calculate the row/src and column/tar
-				const auto src = idx / n;
-				const auto tar = idx % n;
-				return EdgeDescriptor{src, tar, i->exists};
+				return EdgeDescriptor{src, wordIdx * wordBits + std::countr_zero(cur)};
+			}
+
+			bool equal(const iterator &other) const {
+				return src == other.src && wordIdx == other.wordIdx && cur == other.cur;
+			}
+
+			void increment() {
+				cur &= cur - 1;
+				skipEmpty();
 			}
-		public:
-			MatrixIterator first;
-			std::size_t n;
-		};
 
-		// Now wrap the matrix iterator such that entries
-		// without an edge are skipped.
-		struct EdgeExistPred {
-			bool operator()(const EdgeDescriptor &e) const {
-				return e.exists;
+			void skipEmpty() {
+				while(cur == 0) {
+					if(++wordIdx == g->usedWords()) {
+						wordIdx = 0;
+						if(++src == g->n) return;
+					}
+					cur = g->row(src)[wordIdx];
+				}
 			}
+		private:
+			const AdjacencyMatrix *g = nullptr;
+			std::size_t src = 0, wordIdx = 0;
+			Word cur = 0;
 		};
-		using iterator = boost::filter_iterator<EdgeExistPred, MatrixAdaptorIterator>;
 	public:
 		EdgeRange(const AdjacencyMatrix *g) : g(g) { }
 
-		iterator begin() const {
-			return iterator(
-				MatrixAdaptorIterator(g->matrix.begin(), g->matrix.begin(), g->n),
-				MatrixAdaptorIterator(g->matrix.end(), g->matrix.begin(), g->n)
-			);
-		}
-
-		iterator end() const {
-			return iterator(
-				MatrixAdaptorIterator(g->matrix.end(), g->matrix.begin(), g->n),
-				MatrixAdaptorIterator(g->matrix.end(), g->matrix.begin(), g->n)
-			);
-		}
+		iterator begin() const { return iterator(g, 0); }
+		iterator end()   const { return iterator(g, g->n); }
 	private:
 		const AdjacencyMatrix *g;
 	};
 public: // Incidence
 	struct OutEdgeRange {
-		// we can reuse the EdgeRange::iterator
-		// as the out-edges are simply a sub-range of the edges.
-		// For example, in the following adj. matrix (. means no edge, e means edge)
-		// stored in row-major in the underlying vector, then a row is the out-edges
-		// for that vertex, which is a subrange of the underlying vector
+		// The out-edges of a vertex are the set bits of its row in the row-major bitmap,
+		// e.g. in the following matrix (. means no edge, e means edge) the out-edges of
+		// vertex 1 are the set bits among bits 0 through n-1 of the second row.
 		//   0 1 2 3 4 ... n-1
-		// 0 . e . e e          entires  0 through  n-1 of the vector
-		// 1 e . e e e          entries  n through 2n-1 of the vector
-		// 2 . e . . .          entries 2n through 3n-1 of the vector
+		// 0 . e . e e
+		// 1 e . e e e
+		// 2 . e . . .
 		// ...
-		using iterator = typename EdgeRange::iterator;
+		// Rows are `stride` bits apart; the bits between n and stride are unused
+		// capacity that never holds an edge.
+		using iterator = BitIterator<false>;
 	public:
 		OutEdgeRange(VertexDescriptor v, const AdjacencyMatrix &g) : src(v), g(&g) { }
 
-		iterator begin() const {
-			// src is the row number, each row has n entries
-			auto first = g->matrix.begin() + src * g->n;
-			auto last = g->matrix.begin() + (src + 1) * g->n;
-			return iterator(
-				typename EdgeRange::MatrixAdaptorIterator(
-					first, g->matrix.begin(), g->n),
-				typename EdgeRange::MatrixAdaptorIterator(
-					last,  g->matrix.begin(), g->n)
-			);
-		}	
-		
-		iterator end() const {
-			// src is the row number, each row has n entries
-			auto last = g->matrix.begin() + (src + 1) * g->n;
-			return iterator(
-				typename EdgeRange::MatrixAdaptorIterator(
-					last, g->matrix.begin(), g->n),
-				typename EdgeRange::MatrixAdaptorIterator(
-					last, g->matrix.begin(), g->n)
-			);
-		}
+		iterator begin() const { return iterator(g->row(src), 0, g->usedWords(), src); }
+		iterator end()   const { return iterator(g->row(src), g->usedWords(), g->usedWords(), src); }
 	private:
 		std::size_t src;
 		const AdjacencyMatrix *g;
-	};	
+	};
+public: // Bidirectional
+	struct InEdgeRange {
+		// the same scan over the column bitmap of the transposed copy
+		using iterator = BitIterator<true>;
+	public:
+		InEdgeRange(VertexDescriptor v, const AdjacencyMatrix &g) : tar(v), g(&g) { }
+
+		iterator begin() const { return iterator(g->column(tar), 0, g->usedWords(), tar); }
+		iterator end()   const { return iterator(g->column(tar), g->usedWords(), g->usedWords(), tar); }
+	private:
+		std::size_t tar;
+		const AdjacencyMatrix *g;
+	};
 public:
-	AdjacencyMatrix(std::size_t n) : n(n), matrix(n * n) {}
+	AdjacencyMatrix(std::size_t n = 0)
+		: n(n), stride(n), rows(n * wordsFor(n)), columns(n * wordsFor(n)),
+		  vProps(hasVProp ? n : 0), eProps(hasEProp ? n * n : 0) {}
+private:
+	static std::size_t wordsFor(std::size_t numVertices) {
+		return (numVertices + wordBits - 1) / wordBits;
+	}
+
+	// words per row and per column, enough for stride vertices
+	std::size_t lineWords() const { return wordsFor(stride); }
+
+	// words of a row or column that can hold bits, enough for n vertices
+	std::size_t usedWords() const { return wordsFor(n); }
+
+	const Word *row(VertexDescriptor src) const { return rows.data() + src * lineWords(); }
+
+	const Word *column(VertexDescriptor tar) const { return columns.data() + tar * lineWords(); }
+
+	bool hasBit(VertexDescriptor src, VertexDescriptor tar) const {
+		return (row(src)[tar / wordBits] >> (tar % wordBits)) & 1;
+	}
+
+	// Sets or clears the bit of (src, tar) in both bitmaps.
+	void setBit(VertexDescriptor src, VertexDescriptor tar, bool exists) {
+		auto update = [exists](Word &w, std::size_t pos) {
+			const Word bit = Word(1) << (pos % wordBits);
+			w = exists ? (w | bit) : (w & ~bit);
+		};
+		update(rows[src * lineWords() + tar / wordBits], tar);
+		update(columns[tar * lineWords() + src / wordBits], src);
+	}
+
+	// index of (src, tar) in the edge property array
+	std::size_t cell(VertexDescriptor src, VertexDescriptor tar) const {
+		return src * stride + tar;
+	}
+
+	// Moves everything to rows of `newStride` entries, newStride must be at least n.
+	void restride(std::size_t newStride) {
+		const std::size_t newWords = wordsFor(newStride);
+		auto moveBitmap = [&](std::vector<Word> &bits) {
+			std::vector<Word> moved(newStride * newWords);
+			for(std::size_t v = 0; v < n; ++v)
+				std::copy_n(bits.begin() + v * lineWords(), usedWords(), moved.begin() + v * newWords);
+			bits.swap(moved);
+		};
+		moveBitmap(rows);
+		moveBitmap(columns);
+		if constexpr(hasEProp) {
+			std::vector<EdgePropT> moved(newStride * newStride);
+			for(std::size_t v = 0; v < n; ++v)
+				std::move(eProps.begin() + v * stride, eProps.begin() + v * stride + n,
+				          moved.begin() + v * newStride);
+			eProps.swap(moved);
+		}
+		stride = newStride;
+	}
+
+	// Makes room for one more vertex, doubling the capacity when it is reached.
+	void growForVertex() {
+		if(n == stride) restride(std::max<std::size_t>(1, 2 * stride));
+	}
 private:
 	std::size_t n;
+	// distance between row starts in vertices, the vertex capacity of the matrix
+	std::size_t stride;
 	std::size_t m = 0;
-	Matrix matrix;
+	// bit tar of row src is set iff the edge (src, tar) exists
+	std::vector<Word> rows;
+	// transposed copy of rows, bit src of column tar is set iff the edge (src, tar) exists
+	std::vector<Word> columns;
+	// empty when VertexPropT is NoProp
+	std::vector<VertexPropT> vProps;
+	// stride * stride entries, empty when EdgePropT is NoProp
+	std::vector<EdgePropT> eProps;
 public: // Graph
 	friend VertexDescriptor source(const EdgeDescriptor &e,
 	                               const AdjacencyMatrix &g) {
@@ -193,25 +296,170 @@ public: // EdgeList
 	}
 public: // Incidence
 	friend std::size_t outDegree(VertexDescriptor v, const AdjacencyMatrix &g) {
-		auto oe = outEdges(v, g);
-		return std::distance(oe.begin(), oe.end());
+		const Word *r = g.row(v);
+		std::size_t degree = 0;
+		for(std::size_t i = 0; i < g.usedWords(); ++i) degree += std::popcount(r[i]);
+		return degree;
 	}
 
 	friend OutEdgeRange outEdges(VertexDescriptor v, const AdjacencyMatrix &g) {
 		return OutEdgeRange(v, g);
 	}
+
+	// Constant time lookup of the bit for (src, tar).
+	friend std::optional<EdgeDescriptor> edge(VertexDescriptor src, VertexDescriptor tar,
+	                                          const AdjacencyMatrix &g) {
+		if(!g.hasBit(src, tar)) return std::nullopt;
+		return EdgeDescriptor{src, tar};
+	}
+public: // Bidirectional
+	friend std::size_t inDegree(VertexDescriptor v, const AdjacencyMatrix &g) {
+		const Word *col = g.column(v);
+		std::size_t degree = 0;
+		for(std::size_t i = 0; i < g.usedWords(); ++i) degree += std::popcount(col[i]);
+		return degree;
+	}
+
+	friend InEdgeRange inEdges(VertexDescriptor v, const AdjacencyMatrix &g) {
+		return InEdgeRange(v, g);
+	}
 public: // Mutable
+	/**
+	 * @brief Adds an isolated vertex. When the capacity is reached the rows are moved to a
+	 * 			matrix with twice the stride, so n additions cost amortised O(n) each.
+	 * 			For the function to be valid VertexPropT must be default constructible.
+	 */
+	friend VertexDescriptor addVertex(AdjacencyMatrix &g)
+	requires(std::is_default_constructible_v<VertexProp>) {
+		g.growForVertex();
+		if constexpr(hasVProp) g.vProps.emplace_back();
+		return g.n++;
+	}
+
+	/**
+	 * @brief For the function to be valid EdgePropT must be default constructible.
+	 * 			The edge from src to tar must not exist yet.
+	 */
 	friend EdgeDescriptor addEdge(VertexDescriptor src, VertexDescriptor tar,
-	                              AdjacencyMatrix &g) {
-		if(g.matrix[src * g.n + tar].exists) assert(false);
+	                              AdjacencyMatrix &g)
+	requires(std::is_default_constructible_v<EdgeProp>) {
+		if(g.hasBit(src, tar)) assert(false);
+		++g.m;
+		g.setBit(src, tar, true);
+		if constexpr(hasEProp) g.eProps[g.cell(src, tar)] = EdgePropT();
+		return EdgeDescriptor{src, tar};
+	}
+
+	/**
+	 * @brief Bulk version of addEdge, edges that already exist are skipped.
+	 * 			If the elements are pairs the EdgePropT type parameter must be default constructible,
+	 * 			if they are triples the third element is copied as the EdgeProp.
+	 *
+	 * @param es forward range of std::pair(src, tar) or std::tuple(src, tar, EdgeProp)
+	 */
+	template<std::ranges::forward_range EdgePairRange>
+	friend void addEdges(const EdgePairRange &es, AdjacencyMatrix &g) {
+		GRAPH_PHASE("addEdges");
+		using Elem = std::ranges::range_value_t<EdgePairRange>;
+		constexpr bool withProp = std::tuple_size_v<Elem> == 3;
+		static_assert(withProp || std::is_default_constructible_v<EdgeProp>);
+		for(const auto &x : es) {
+			const auto src = std::get<0>(x), tar = std::get<1>(x);
+			if(g.hasBit(src, tar)) continue;
+			++g.m;
+			g.setBit(src, tar, true);
+			if constexpr(hasEProp) {
+				if constexpr(withProp) g.eProps[g.cell(src, tar)] = std::get<2>(x);
+				else g.eProps[g.cell(src, tar)] = EdgePropT();
+			}
+		}
+	}
+
+	// Constant time removal of the edge from src to tar, which must exist.
+	friend void removeEdge(VertexDescriptor src, VertexDescriptor tar, AdjacencyMatrix &g) {
+		assert(g.hasBit(src, tar));
+		g.setBit(src, tar, false);
+		--g.m;
+	}
+
+	friend void removeEdge(const EdgeDescriptor &e, AdjacencyMatrix &g) {
+		removeEdge(e.src, e.tar, g);
+	}
+public: // MutablePropertyGraph
+	/**
+	 * @brief For the function to be valid the VertexProp type parameter
+	 * 			must be move assignable and must not be NoProp type
+	 */
+	friend VertexDescriptor addVertex(VertexProp &&vp, AdjacencyMatrix &g)
+	requires(hasVProp && std::movable<VertexProp>) {
+		g.growForVertex();
+		g.vProps.push_back(std::move(vp));
+		return g.n++;
+	}
+
+	/**
+	 * @brief For the function to be valid the EdgeProp type parameter
+	 * 			must be move assignable and must not be NoProp type.
+	 * 			The edge from src to tar must not exist yet.
+	 */
+	friend EdgeDescriptor addEdge(VertexDescriptor src, VertexDescriptor tar, EdgeProp &&ep,
+	                              AdjacencyMatrix &g)
+	requires(hasEProp && std::movable<EdgeProp>) {
+		if(g.hasBit(src, tar)) assert(false);
 		++g.m;
-		g.matrix[src * g.n + tar].exists = true;
-		return EdgeDescriptor{src, tar, true};
+		g.setBit(src, tar, true);
+		g.eProps[g.cell(src, tar)] = std::move(ep);
+		return EdgeDescriptor{src, tar};
+	}
+public: // Memory
+	/**
+	 * @brief The row bitmaps are the edge array, the column bitmaps the adjacency entries and
+	 * 			the n vertex and n * n edge properties the properties, whether an edge exists or not.
+	 * 			The spare vertex capacity of all of them is slack.
+	 */
+	friend MemoryUsage memoryUsage(const AdjacencyMatrix &g) {
+		MemoryUsage usage;
+		usage.edgeArray = g.n * g.usedWords() * sizeof(Word);
+		usage.adjacencySize = usage.edgeArray;
+		usage.adjacencyCapacity = g.columns.capacity() * sizeof(Word);
+		const std::size_t ePropSize = hasEProp ? g.n * g.n * sizeof(EdgePropT) : 0;
+		usage.properties = detail::usedBytes(g.vProps) + ePropSize;
+		usage.slack = g.rows.capacity() * sizeof(Word) - usage.edgeArray
+		            + usage.adjacencyCapacity - usage.adjacencySize
+		            + detail::slackBytes(g.vProps)
+		            + g.eProps.capacity() * sizeof(EdgePropT) - ePropSize;
+		return usage;
+	}
+
+	// Drops the spare vertex capacity, so the stride becomes n.
+	friend void shrinkToFit(AdjacencyMatrix &g) {
+		if(g.stride != g.n) g.restride(g.n);
+		g.rows.shrink_to_fit();
+		g.columns.shrink_to_fit();
+		g.vProps.shrink_to_fit();
+		g.eProps.shrink_to_fit();
 	}
 public: // Other
 	friend std::size_t getIndex(VertexDescriptor v, const AdjacencyMatrix &g) {
 		return v;
 	}
+public: // PropertyGraph
+	VertexProp &operator[](VertexDescriptor v) requires(hasVProp) {
+		return vProps[v];
+	}
+
+	const VertexProp &operator[](VertexDescriptor v) const requires(hasVProp) {
+		return vProps[v];
+	}
+
+	// The property of a removed or never added edge is unspecified.
+	EdgeProp &operator[](const EdgeDescriptor &e) requires(hasEProp) {
+		return eProps[cell(e.src, e.tar)];
+	}
+
+	const EdgeProp &operator[](const EdgeDescriptor &e) const requires(hasEProp) {
+		return eProps[cell(e.src, e.tar)];
+	}
 };
 
 } // namespace graph
@@ -0,0 +1,115 @@
+#ifndef GRAPH_ARENA_HPP
+#define GRAPH_ARENA_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Monotonic memory resource for building graphs, to be used with graph::pmr::AdjacencyList.
+ * 			Allocations are carved from large chunks by bumping a pointer, so building a graph with
+ * 			millions of vertices does a handful of upstream allocations instead of one per edge list.
+ * 			Deallocation is a no-op except for the most recent allocation, which is rolled back, so a
+ * 			temporary buffer freed before the next allocation costs no space. A growing edge list
+ * 			leaves its old block behind, as containers allocate the new block before freeing the old
+ * 			one; addEdges() reserves every list once, so bulk loading wastes little. Everything is
+ * 			freed at once by release() or on destruction, so the arena must outlive every graph using it.
+ */
+class GraphArena : public std::pmr::memory_resource {
+public:
+	/**
+	 * @param initialChunkSize size of the first chunk, later chunks double up to maxChunkSize
+	 * @param upstream resource the chunks are allocated from
+	 */
+	explicit GraphArena(std::size_t initialChunkSize = std::size_t(1) << 16,
+	                    std::pmr::memory_resource *upstream = std::pmr::new_delete_resource())
+		: nextChunkSize(std::max<std::size_t>(initialChunkSize, 64)), upstream(upstream) {}
+
+	GraphArena(const GraphArena&) = delete;
+	GraphArena &operator=(const GraphArena&) = delete;
+
+	~GraphArena() override { release(); }
+
+	// Frees every chunk, invalidating all memory handed out by the arena.
+	void release() {
+		for(const Chunk &c : chunks) upstream->deallocate(c.data, c.size, alignof(std::max_align_t));
+		chunks.clear();
+		cur = end = nullptr;
+		last = nullptr;
+		used = 0;
+	}
+
+	// Bytes currently handed out, not counting rolled back allocations.
+	std::size_t bytesAllocated() const { return used; }
+
+	// Bytes obtained from the upstream resource.
+	std::size_t bytesReserved() const {
+		std::size_t total = 0;
+		for(const Chunk &c : chunks) total += c.size;
+		return total;
+	}
+
+	std::size_t numChunks() const { return chunks.size(); }
+private:
+	static constexpr std::size_t maxChunkSize = std::size_t(1) << 28;
+
+	struct Chunk {
+		std::byte *data;
+		std::size_t size;
+	};
+
+	// Bytes to skip from `p` to the next multiple of `alignment`.
+	static std::size_t padding(const std::byte *p, std::size_t alignment) {
+		return (alignment - reinterpret_cast<std::uintptr_t>(p) % alignment) % alignment;
+	}
+
+	void *do_allocate(std::size_t bytes, std::size_t alignment) override {
+		// compare sizes, not pointers, so no pointer past the end of the chunk is formed
+		const std::size_t space = static_cast<std::size_t>(end - cur);
+		const std::size_t pad = cur ? padding(cur, alignment) : 0;
+		std::byte *p;
+		if(cur && pad <= space && bytes <= space - pad) {
+			p = cur + pad;
+		} else {
+			// chunks are aligned to max_align_t, larger alignments need some slack
+			const std::size_t need = bytes + (alignment > alignof(std::max_align_t) ? alignment : 0);
+			const std::size_t size = std::max(nextChunkSize, need);
+			nextChunkSize = std::min(nextChunkSize * 2, maxChunkSize);
+			std::byte *data = static_cast<std::byte*>(upstream->allocate(size, alignof(std::max_align_t)));
+			chunks.push_back(Chunk{data, size});
+			end = data + size;
+			p = data + padding(data, alignment);
+		}
+		last = p;
+		cur = p + bytes;
+		used += bytes;
+		return p;
+	}
+
+	void do_deallocate(void *p, std::size_t bytes, std::size_t) override {
+		// only the most recent allocation can be given back
+		if(p == last && static_cast<std::byte*>(p) + bytes == cur) {
+			cur = last;
+			last = nullptr;
+			used -= bytes;
+		}
+	}
+
+	bool do_is_equal(const std::pmr::memory_resource &other) const noexcept override {
+		return this == &other;
+	}
+private:
+	std::size_t nextChunkSize;
+	std::pmr::memory_resource *upstream;
+	std::vector<Chunk> chunks;
+	std::byte *cur = nullptr, *end = nullptr, *last = nullptr;
+	std::size_t used = 0;
+};
+
+} // namespace graph
+
+#endif // GRAPH_ARENA_HPP
@@ -0,0 +1,92 @@
+#ifndef GRAPH_BREADTH_FIRST_SEARCH_HPP
+#define GRAPH_BREADTH_FIRST_SEARCH_HPP
+
+#include "instrumentation.hpp"
+#include "property_map.hpp"
+#include "traits.hpp"
+#include <vector>
+
+namespace graph {
+
+struct BFSNullVisitor {
+	template<typename G, typename V>
+	void initVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void startVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void discoverVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void examineVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void finishVertex(const V&, const G&) { }
+
+	template<typename G, typename E>
+	void examineEdge(const E&, const G&) { }
+
+	template<typename G, typename E>
+	void treeEdge(const E&, const G&) { }
+
+	template<typename G, typename E>
+	void nonTreeEdge(const E&, const G&) { }
+};
+
+/**
+ * @brief BFS from the single vertex `start` over the out edges. A vertex is discovered when it is
+ * 			queued and examined and finished when it is dequeued, so the vertices discovered but not
+ * 			finished are exactly the queue. The visited map is not initialised, every vertex not yet
+ * 			visited must read as false; with a GenerationVisitedSet that is cleared between calls,
+ * 			repeated searches cost O(visited) instead of O(V).
+ * @param g graph to perform BFS on
+ * @param start vertex to start from, skipped if it is already visited
+ * @param visitor object descriping the behavior when traversing, initVertex is not called.
+ * @param visited map with a key for every vertex index, true for every vertex reached afterwards.
+ */
+template<typename Graph, typename Visitor, ReadWritePropertyMap<bool> VisitedMap>
+void bfs(const Graph &g, typename Traits<Graph>::VertexDescriptor start, Visitor visitor, VisitedMap &visited) {
+	if(get(visited, getIndex(start, g))) return;
+	GRAPH_PHASE("bfs");
+	// a vector with a read position instead of a std::queue, the queue never shrinks during a search
+	std::vector<typename Traits<Graph>::VertexDescriptor> queue;
+	std::size_t head = 0;
+	visitor.startVertex(start, g);
+	put(visited, getIndex(start, g), true);
+	visitor.discoverVertex(start, g);
+	queue.push_back(start);
+	while(head < queue.size()) {
+		const auto u = queue[head++];
+		visitor.examineVertex(u, g);
+		for(auto e : outEdges(u, g)) {
+			auto v = target(e, g);
+			visitor.examineEdge(e, g);
+			if(!get(visited, getIndex(v, g))) {
+				visitor.treeEdge(e, g);
+				put(visited, getIndex(v, g), true);
+				visitor.discoverVertex(v, g);
+				queue.push_back(v);
+			} else
+				visitor.nonTreeEdge(e, g);
+		}
+		visitor.finishVertex(u, g);
+	}
+}
+
+/**
+ * @brief BFS from `start`, calling initVertex for every vertex first.
+ * @param g graph to perform BFS on
+ * @param start vertex to start from
+ * @param visitor object descriping the behavior when traversing.
+ */
+template<typename Graph, typename Visitor>
+void bfs(const Graph &g, typename Traits<Graph>::VertexDescriptor start, Visitor visitor) {
+	BitPropertyMap visited(numVertices(g));
+	for(auto v : vertices(g)) visitor.initVertex(v, g);
+	bfs(g, start, visitor, visited);
+}
+
+} // namespace graph
+
+#endif // GRAPH_BREADTH_FIRST_SEARCH_HPP
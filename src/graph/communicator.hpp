@@ -0,0 +1,225 @@
+#ifndef GRAPH_COMMUNICATOR_HPP
+#define GRAPH_COMMUNICATOR_HPP
+
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Message layer between the ranks of a distributed computation on one machine.
+ * 			Every pair of ranks is connected by a Unix domain socket pair, so the ranks can be
+ * 			threads of one process or processes forked after createLocal() (see runProcesses()).
+ * 			All communication is collective: every rank must call the same sequence of
+ * 			exchange() and allReduceSum(), as in a bulk synchronous superstep.
+ */
+class Communicator {
+public:
+	Communicator(const Communicator&) = delete;
+	Communicator &operator=(const Communicator&) = delete;
+
+	Communicator(Communicator &&other) noexcept
+		: r(other.r), fds(std::move(other.fds)) {
+		other.fds.clear();
+	}
+
+	Communicator &operator=(Communicator &&other) noexcept {
+		std::swap(r, other.r);
+		std::swap(fds, other.fds);
+		return *this;
+	}
+
+	~Communicator() { close(); }
+
+	/**
+	 * @brief Creates `size` connected communicators, one per rank.
+	 */
+	static std::vector<Communicator> createLocal(std::size_t size) {
+		std::vector<Communicator> comms;
+		for(std::size_t i = 0; i < size; ++i) comms.push_back(Communicator(i, size));
+		for(std::size_t i = 0; i < size; ++i) {
+			for(std::size_t j = i + 1; j < size; ++j) {
+				int sv[2];
+				if(::socketpair(AF_UNIX, SOCK_STREAM, 0, sv) != 0) fail("socketpair");
+				for(int fd : sv) {
+					if(::fcntl(fd, F_SETFL, ::fcntl(fd, F_GETFL) | O_NONBLOCK) != 0) fail("fcntl");
+				}
+				comms[i].fds[j] = sv[0];
+				comms[j].fds[i] = sv[1];
+			}
+		}
+		return comms;
+	}
+
+	std::size_t rank() const { return r; }
+	std::size_t size() const { return fds.size(); }
+
+	// Closes all sockets of this rank.
+	void close() {
+		for(int &fd : fds) {
+			if(fd >= 0) ::close(fd);
+			fd = -1;
+		}
+	}
+
+	/**
+	 * @brief Sends `outgoing[q]` to every other rank q and receives what every other rank sent
+	 * 			to this one. Sends and receives are interleaved with poll(), so arbitrarily large
+	 * 			batches cannot deadlock on full socket buffers.
+	 * @tparam T trivially copyable message type
+	 * @param outgoing one batch per rank, `outgoing[rank()]` is passed through unchanged
+	 * @return one batch per rank, the batch rank q sent to this rank.
+	 */
+	template<typename T>
+	std::vector<std::vector<T>> exchange(std::vector<std::vector<T>> outgoing) {
+		static_assert(std::is_trivially_copyable_v<T>);
+		if(outgoing.size() != size()) throw std::invalid_argument("exchange: need one batch per rank");
+
+		struct Peer {
+			std::vector<char> out;
+			std::size_t sent = 0;
+			std::vector<char> in;
+			std::size_t received = 0;
+			bool haveHeader = false;
+		};
+		std::vector<Peer> peers(size());
+		std::size_t pending = 0;
+		for(std::size_t q = 0; q < size(); ++q) {
+			if(q == r) continue;
+			const std::uint64_t bytes = outgoing[q].size() * sizeof(T);
+			Peer &p = peers[q];
+			p.out.resize(sizeof(bytes) + bytes);
+			std::memcpy(p.out.data(), &bytes, sizeof(bytes));
+			if(bytes) std::memcpy(p.out.data() + sizeof(bytes), outgoing[q].data(), bytes);
+			p.in.resize(sizeof(std::uint64_t));
+			pending += 2;
+		}
+
+		std::vector<pollfd> pfds;
+		std::vector<std::size_t> pfdPeer;
+		while(pending) {
+			pfds.clear();
+			pfdPeer.clear();
+			for(std::size_t q = 0; q < size(); ++q) {
+				if(q == r) continue;
+				const Peer &p = peers[q];
+				short events = 0;
+				if(p.sent < p.out.size()) events |= POLLOUT;
+				if(p.received < p.in.size()) events |= POLLIN;
+				if(!events) continue;
+				pfds.push_back(pollfd{fds[q], events, 0});
+				pfdPeer.push_back(q);
+			}
+			if(::poll(pfds.data(), pfds.size(), -1) < 0) {
+				if(errno == EINTR) continue;
+				fail("poll");
+			}
+			for(std::size_t i = 0; i < pfds.size(); ++i) {
+				Peer &p = peers[pfdPeer[i]];
+				if(pfds[i].revents & (POLLERR | POLLNVAL)) throw std::runtime_error("exchange: broken connection");
+				if(pfds[i].revents & POLLOUT) {
+					const ssize_t k = ::send(pfds[i].fd, p.out.data() + p.sent, p.out.size() - p.sent, MSG_NOSIGNAL);
+					if(k < 0 && errno != EAGAIN && errno != EINTR) fail("send");
+					if(k > 0) {
+						p.sent += static_cast<std::size_t>(k);
+						if(p.sent == p.out.size()) --pending;
+					}
+				}
+				if(pfds[i].revents & (POLLIN | POLLHUP)) {
+					const ssize_t k = ::recv(pfds[i].fd, p.in.data() + p.received, p.in.size() - p.received, 0);
+					if(k == 0) throw std::runtime_error("exchange: peer closed the connection");
+					if(k < 0 && errno != EAGAIN && errno != EINTR) fail("recv");
+					if(k > 0) p.received += static_cast<std::size_t>(k);
+					if(!p.haveHeader && p.received == p.in.size()) {
+						std::uint64_t bytes;
+						std::memcpy(&bytes, p.in.data(), sizeof(bytes));
+						p.haveHeader = true;
+						p.in.assign(bytes, 0);
+						p.received = 0;
+					}
+					if(p.haveHeader && p.received == p.in.size()) --pending;
+				}
+			}
+		}
+
+		std::vector<std::vector<T>> incoming(size());
+		incoming[r] = std::move(outgoing[r]);
+		for(std::size_t q = 0; q < size(); ++q) {
+			if(q == r) continue;
+			const Peer &p = peers[q];
+			incoming[q].resize(p.in.size() / sizeof(T));
+			if(!p.in.empty()) std::memcpy(incoming[q].data(), p.in.data(), p.in.size());
+		}
+		return incoming;
+	}
+
+	/**
+	 * @return the sum of `value` over all ranks.
+	 */
+	template<typename T>
+	T allReduceSum(T value) {
+		auto incoming = exchange(std::vector<std::vector<T>>(size(), std::vector<T>{value}));
+		T sum{};
+		for(const auto &batch : incoming) sum += batch.front();
+		return sum;
+	}
+private:
+	Communicator(std::size_t rank, std::size_t size) : r(rank), fds(size, -1) {}
+
+	[[noreturn]] static void fail(const char *what) {
+		throw std::runtime_error(std::string("Communicator: ") + what + ": " + std::strerror(errno));
+	}
+private:
+	std::size_t r;
+	std::vector<int> fds;
+};
+
+/**
+ * @brief Runs `f(comm)` for every communicator in its own forked child process and waits for all of them.
+ * 			Each child closes the sockets of the other ranks, runs `f` and exits with status 0
+ * 			if `f` returns true (or 1 if it returns false or throws).
+ * 			The parent closes all sockets.
+ * @return true if every child exited with status 0.
+ */
+template<typename F>
+bool runProcesses(std::vector<Communicator> &comms, F f) {
+	std::vector<pid_t> children;
+	for(std::size_t i = 0; i < comms.size(); ++i) {
+		const pid_t pid = ::fork();
+		if(pid < 0) throw std::runtime_error(std::string("runProcesses: fork: ") + std::strerror(errno));
+		if(pid == 0) {
+			for(std::size_t j = 0; j < comms.size(); ++j)
+				if(j != i) comms[j].close();
+			int status = 1;
+			try {
+				status = f(comms[i]) ? 0 : 1;
+			} catch(...) {}
+			::_exit(status);
+		}
+		children.push_back(pid);
+	}
+	for(auto &comm : comms) comm.close();
+	bool ok = true;
+	for(pid_t pid : children) {
+		int status = 0;
+		while(::waitpid(pid, &status, 0) < 0 && errno == EINTR) {}
+		ok = ok && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+	}
+	return ok;
+}
+
+} // namespace graph
+
+#endif // GRAPH_COMMUNICATOR_HPP
@@ -0,0 +1,349 @@
+#ifndef GRAPH_COMPRESSED_GRAPH_HPP
+#define GRAPH_COMPRESSED_GRAPH_HPP
+
+#include "instrumentation.hpp"
+#include "memory_usage.hpp"
+#include "parallel.hpp"
+#include "tags.hpp"
+#include "traits.hpp"
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace graph {
+namespace detail {
+
+// Appends `x` as a little endian base-128 varint: 7 bits per byte, high bit set on all but the last byte.
+inline void putVarint(std::vector<std::uint8_t> &out, std::uint64_t x) {
+	while(x >= 0x80) {
+		out.push_back(static_cast<std::uint8_t>(x | 0x80));
+		x >>= 7;
+	}
+	out.push_back(static_cast<std::uint8_t>(x));
+}
+
+// Decodes a varint written by putVarint() and advances `p` past it.
+inline std::uint64_t getVarint(const std::uint8_t *&p) {
+	std::uint64_t x = *p & 0x7f;
+	unsigned shift = 7;
+	while(*p++ & 0x80) {
+		x |= std::uint64_t(*p & 0x7f) << shift;
+		shift += 7;
+	}
+	return x;
+}
+
+inline std::uint64_t zigzag(std::int64_t x) {
+	return (static_cast<std::uint64_t>(x) << 1) ^ static_cast<std::uint64_t>(x >> 63);
+}
+
+inline std::int64_t unzigzag(std::uint64_t x) {
+	return static_cast<std::int64_t>(x >> 1) ^ -static_cast<std::int64_t>(x & 1);
+}
+
+} // namespace detail
+
+/**
+ * @brief Read-only directed graph storing each vertex's sorted out neighbours gap encoded as
+ * 			byte-aligned varints: the first target relative to the vertex itself (zigzag encoded,
+ * 			as it may be smaller), every further target as the difference to the previous one.
+ * 			Every `skipInterval` entries a skip pointer (byte position and target) is kept,
+ * 			so edge() only decodes one block after a binary search over the skip pointers.
+ * 			Out edges are produced by a decoding iterator, so the graph is an IncidenceGraph,
+ * 			VertexListGraph and EdgeListGraph. Edges are identified by their position in the
+ * 			sorted edge order, so out edges come in increasing target order.
+ */
+struct CompressedGraph {
+private:
+	struct Skip {
+		std::uint64_t byteOffset;
+		std::uint64_t tar;
+	};
+public: // Graph
+	using DirectedCategory = tags::Directed;
+	using VertexDescriptor = std::size_t;
+
+	struct EdgeDescriptor {
+		EdgeDescriptor() = default;
+		EdgeDescriptor(std::size_t src, std::size_t tar, std::size_t idx)
+			: src(src), tar(tar), idx(idx) {}
+	public:
+		std::size_t src, tar;
+		// position of the edge in the sorted edge order
+		std::size_t idx;
+	public:
+		friend bool operator==(const EdgeDescriptor &a, const EdgeDescriptor &b) {
+			return a.idx == b.idx;
+		}
+	};
+public: // VertexListGraph
+	struct VertexRange {
+		using iterator = boost::counting_iterator<VertexDescriptor>;
+	public:
+		VertexRange(std::size_t n) : n(n) {}
+		iterator begin() const { return iterator(0); }
+		iterator end()   const { return iterator(n); }
+	private:
+		std::size_t n;
+	};
+public: // IncidenceGraph
+	struct OutEdgeRange {
+		// Decodes the gaps of one vertex on the fly, each increment reads one varint.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor, std::forward_iterator_tag, EdgeDescriptor> {
+			iterator() = default;
+			iterator(const std::uint8_t *p, std::size_t src, std::size_t idx, std::size_t last)
+				: p(p), src(src), idx(idx), last(last) {
+				if(idx != last) tar = static_cast<std::size_t>(static_cast<std::int64_t>(src) + detail::unzigzag(detail::getVarint(this->p)));
+			}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const { return EdgeDescriptor(src, tar, idx); }
+			bool equal(const iterator &other) const { return idx == other.idx; }
+			void increment() {
+				if(++idx != last) tar += detail::getVarint(p);
+			}
+		private:
+			const std::uint8_t *p = nullptr;
+			std::size_t src = 0, tar = 0, idx = 0, last = 0;
+		};
+	public:
+		OutEdgeRange(VertexDescriptor v, const CompressedGraph &g) : v(v), g(&g) {}
+
+		iterator begin() const {
+			return iterator(g->bytes.data() + g->byteOffsets[v], v, g->edgeOffsets[v], g->edgeOffsets[v + 1]);
+		}
+
+		iterator end() const {
+			return iterator(nullptr, v, g->edgeOffsets[v + 1], g->edgeOffsets[v + 1]);
+		}
+	private:
+		VertexDescriptor v;
+		const CompressedGraph *g;
+	};
+public: // EdgeListGraph
+	struct EdgeRange {
+		// Walks the vertices in order and decodes the out edges of each.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor, std::forward_iterator_tag, EdgeDescriptor> {
+			iterator() = default;
+			iterator(const CompressedGraph *g, std::size_t v) : g(g), v(v) {
+				skipEmpty();
+			}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const { return *inner; }
+			bool equal(const iterator &other) const {
+				return v == other.v && (v == g->vertexCount() || inner == other.inner);
+			}
+			void increment() {
+				if(++inner == OutEdgeRange(v, *g).end()) {
+					++v;
+					skipEmpty();
+				}
+			}
+			void skipEmpty() {
+				while(v != g->vertexCount() && g->edgeOffsets[v] == g->edgeOffsets[v + 1]) ++v;
+				if(v != g->vertexCount()) inner = OutEdgeRange(v, *g).begin();
+			}
+		private:
+			const CompressedGraph *g = nullptr;
+			std::size_t v = 0;
+			typename OutEdgeRange::iterator inner;
+		};
+	public:
+		EdgeRange(const CompressedGraph &g) : g(&g) {}
+		iterator begin() const { return iterator(g, 0); }
+		iterator end()   const { return iterator(g, g->vertexCount()); }
+	private:
+		const CompressedGraph *g;
+	};
+public:
+	/**
+	 * @brief Compresses the out edges of `g`.
+	 * @param g an IncidenceGraph and VertexListGraph
+	 * @param skipInterval number of entries between skip pointers
+	 */
+	template<typename Graph>
+	explicit CompressedGraph(const Graph &g, std::size_t skipInterval = 64)
+		: skipInterval(std::max<std::size_t>(skipInterval, 1)) {
+		GRAPH_PHASE("CompressedGraph");
+		const std::size_t n = numVertices(g);
+		byteOffsets.reserve(n + 1);
+		edgeOffsets.reserve(n + 1);
+		skipOffsets.reserve(n + 1);
+		std::vector<std::size_t> targets;
+		for(auto v : vertices(g)) {
+			targets.clear();
+			for(auto e : outEdges(v, g)) targets.push_back(getIndex(target(e, g), g));
+			std::sort(targets.begin(), targets.end());
+			appendVertex(getIndex(v, g), targets);
+		}
+		finish();
+	}
+
+	/**
+	 * @brief Compresses a list of edges over the vertices [0, n), e.g. from a generator,
+	 * 			without building a graph first. The pairs are grouped by source with a parallel counting sort.
+	 * @param pairs (src, tar) of every edge
+	 * @param skipInterval number of entries between skip pointers
+	 */
+	CompressedGraph(std::size_t n, const std::vector<std::pair<std::size_t, std::size_t>> &pairs,
+	                std::size_t skipInterval = 64)
+		: skipInterval(std::max<std::size_t>(skipInterval, 1)) {
+		GRAPH_PHASE("CompressedGraph");
+		const auto bySource = detail::countingSort(pairs, n, [](const auto &p) { return p.first; });
+		byteOffsets.reserve(n + 1);
+		edgeOffsets.reserve(n + 1);
+		skipOffsets.reserve(n + 1);
+		std::vector<std::size_t> targets;
+		std::size_t i = 0;
+		for(std::size_t v = 0; v < n; ++v) {
+			targets.clear();
+			for(; i < bySource.size() && bySource[i].first == v; ++i) targets.push_back(bySource[i].second);
+			std::sort(targets.begin(), targets.end());
+			appendVertex(v, targets);
+		}
+		finish();
+	}
+private:
+	// Encodes the sorted targets of the next vertex `v`.
+	void appendVertex(std::size_t v, const std::vector<std::size_t> &targets) {
+		const std::size_t first = bytes.size();
+		byteOffsets.push_back(first);
+		edgeOffsets.push_back(numEdgesSoFar);
+		skipOffsets.push_back(skips.size());
+		for(std::size_t i = 0; i < targets.size(); ++i) {
+			if(i == 0) {
+				detail::putVarint(bytes, detail::zigzag(static_cast<std::int64_t>(targets[0]) - static_cast<std::int64_t>(v)));
+				continue;
+			}
+			if(i % skipInterval == 0) skips.push_back(Skip{bytes.size() - first, targets[i - 1]});
+			detail::putVarint(bytes, targets[i] - targets[i - 1]);
+		}
+		numEdgesSoFar += targets.size();
+	}
+
+	void finish() {
+		byteOffsets.push_back(bytes.size());
+		edgeOffsets.push_back(numEdgesSoFar);
+		skipOffsets.push_back(skips.size());
+		// the graph is read-only from here on, so drop the growth slack of the encoding
+		byteOffsets.shrink_to_fit();
+		edgeOffsets.shrink_to_fit();
+		skipOffsets.shrink_to_fit();
+		bytes.shrink_to_fit();
+		skips.shrink_to_fit();
+	}
+
+	std::size_t vertexCount() const { return byteOffsets.size() - 1; }
+private:
+	std::size_t skipInterval;
+	std::size_t numEdgesSoFar = 0;
+	std::vector<std::uint8_t> bytes;
+	std::vector<std::size_t> byteOffsets;
+	std::vector<std::size_t> edgeOffsets;
+	std::vector<std::size_t> skipOffsets;
+	// skip pointer k of a vertex is before entry (k + 1) * skipInterval and holds the previous target
+	std::vector<Skip> skips;
+public: // Graph
+	friend VertexDescriptor source(const EdgeDescriptor &e, const CompressedGraph &) {
+		return e.src;
+	}
+
+	friend VertexDescriptor target(const EdgeDescriptor &e, const CompressedGraph &) {
+		return e.tar;
+	}
+public: // VertexListGraph
+	friend std::size_t numVertices(const CompressedGraph &g) {
+		return g.vertexCount();
+	}
+
+	friend VertexRange vertices(const CompressedGraph &g) {
+		return VertexRange(g.vertexCount());
+	}
+public: // EdgeListGraph
+	friend std::size_t numEdges(const CompressedGraph &g) {
+		return g.numEdgesSoFar;
+	}
+
+	friend EdgeRange edges(const CompressedGraph &g) {
+		return EdgeRange(g);
+	}
+public: // IncidenceGraph
+	friend OutEdgeRange outEdges(VertexDescriptor v, const CompressedGraph &g) {
+		return OutEdgeRange(v, g);
+	}
+
+	friend std::size_t outDegree(VertexDescriptor v, const CompressedGraph &g) {
+		return g.edgeOffsets[v + 1] - g.edgeOffsets[v];
+	}
+
+	/**
+	 * @brief Binary search over the skip pointers of `src`, then decodes at most skipInterval entries.
+	 * @return the edge from `src` to `tar` with the lowest position, or std::nullopt if there is none.
+	 */
+	friend std::optional<EdgeDescriptor> edge(VertexDescriptor src, VertexDescriptor tar, const CompressedGraph &g) {
+		const std::size_t degree = outDegree(src, g);
+		if(degree == 0) return std::nullopt;
+		const Skip *first = g.skips.data() + g.skipOffsets[src];
+		const Skip *last = g.skips.data() + g.skipOffsets[src + 1];
+		// the last skip pointer whose previous target is below `tar`
+		const Skip *s = std::lower_bound(first, last, tar, [](const Skip &skip, std::size_t t) {
+			return skip.tar < t;
+		});
+		const std::uint8_t *base = g.bytes.data() + g.byteOffsets[src];
+		std::size_t i, cur;
+		const std::uint8_t *p;
+		if(s == first) {
+			i = 0;
+			p = base;
+			cur = static_cast<std::size_t>(static_cast<std::int64_t>(src) + detail::unzigzag(detail::getVarint(p)));
+		} else {
+			--s;
+			i = static_cast<std::size_t>(s - first + 1) * g.skipInterval;
+			p = base + s->byteOffset;
+			cur = static_cast<std::size_t>(s->tar + detail::getVarint(p));
+		}
+		while(true) {
+			if(cur == tar) return EdgeDescriptor(src, tar, g.edgeOffsets[src] + i);
+			if(cur > tar || ++i == degree) return std::nullopt;
+			cur += detail::getVarint(p);
+		}
+	}
+public: // Memory
+	// The offset arrays are the vertex array, the encoded bytes and the skip pointers the edge array.
+	friend MemoryUsage memoryUsage(const CompressedGraph &g) {
+		MemoryUsage usage;
+		usage.vertexArray = detail::usedBytes(g.byteOffsets) + detail::usedBytes(g.edgeOffsets) + detail::usedBytes(g.skipOffsets);
+		usage.edgeArray = detail::usedBytes(g.bytes) + detail::usedBytes(g.skips);
+		usage.slack = detail::slackBytes(g.byteOffsets) + detail::slackBytes(g.edgeOffsets)
+			+ detail::slackBytes(g.skipOffsets) + detail::slackBytes(g.bytes) + detail::slackBytes(g.skips);
+		return usage;
+	}
+
+	// The arrays are already trimmed by the constructors, provided for generic code.
+	friend void shrinkToFit(CompressedGraph &g) {
+		g.byteOffsets.shrink_to_fit();
+		g.edgeOffsets.shrink_to_fit();
+		g.skipOffsets.shrink_to_fit();
+		g.bytes.shrink_to_fit();
+		g.skips.shrink_to_fit();
+	}
+public: // Other
+	friend std::size_t getIndex(VertexDescriptor v, const CompressedGraph &) {
+		return v;
+	}
+};
+
+} // namespace graph
+
+#endif // GRAPH_COMPRESSED_GRAPH_HPP
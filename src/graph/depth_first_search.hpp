@@ -1,6 +1,8 @@
 #ifndef GRAPH_DEPTH_FIRST_SEARCH_HPP
 #define GRAPH_DEPTH_FIRST_SEARCH_HPP
 
+#include "instrumentation.hpp"
+#include "property_map.hpp"
 #include "traits.hpp"
 #include <vector>
 
@@ -35,39 +37,41 @@ struct DFSNullVisitor {
 	void finishEdge(const E&, const G&) { }
 };
 
-namespace detail {
-
 enum struct DFSColour {
 	White, Grey, Black
 };
 
+namespace detail {
+
 /**
  * @brief DFS visit algorithm following the pseudo-code from the book Introduction to Algorithms and the Boost Graph library.
  * @tparam Graph graph type AdjacencyList or AdjacencyMatrix
  * @tparam Visitor type, DFSNullVisitor or TopoVisitor
+ * @tparam ColourMap property map from vertex index to DFSColour
  * @param g graph to perform DFS on
  * @param visitor object descriping the behavior when traversing.
  * @param u VertexDescriptor for the vertex to visit.
- * @param colour array.
+ * @param colour map.
  */
-template<typename Graph, typename Visitor>
+template<typename Graph, typename Visitor, typename ColourMap>
 void dfsVisit(const Graph &g, Visitor visitor, typename Traits<Graph>::VertexDescriptor u,
-		std::vector<DFSColour> &colour) {
+		ColourMap &colour) {
 	visitor.discoverVertex(u, g);
-	colour[u] = graph::detail::DFSColour::Grey;
-	for (auto e = outEdges(u, g).begin(); e != outEdges(u,g).end(); e++) {
-		auto v = (*e).tar;
-		visitor.examineEdge(*e, g);
-		if(colour[v] == graph::detail::DFSColour::White) {
-			visitor.treeEdge(*e, g);
+	put(colour, getIndex(u, g), DFSColour::Grey);
+	for (auto e : outEdges(u, g)) {
+		auto v = target(e, g);
+		visitor.examineEdge(e, g);
+		const DFSColour c = get(colour, getIndex(v, g));
+		if(c == DFSColour::White) {
+			visitor.treeEdge(e, g);
 			dfsVisit(g, visitor, v, colour);
-		} else if (colour[v] == graph::detail::DFSColour::Grey)
-			visitor.backEdge(*e, g);
+		} else if (c == DFSColour::Grey)
+			visitor.backEdge(e, g);
 		else
-			visitor.forwardOrCrossEdge(*e, g);
-		visitor.finishEdge(*e, g);
+			visitor.forwardOrCrossEdge(e, g);
+		visitor.finishEdge(e, g);
 	}
-	colour[u] = graph::detail::DFSColour::Black;
+	put(colour, getIndex(u, g), DFSColour::Black);
 	visitor.finishVertex(u, g);
 }
 
@@ -75,26 +79,64 @@ void dfsVisit(const Graph &g, Visitor visitor, typename Traits<Graph>::VertexDes
 
 /**
  * @brief DFS algorithm following the pseudo-code from the book Introduction to Algorithms and the Boost Graph library.
+ * 			The colour of the vertices is kept in a caller provided property map, so the buffer can be
+ * 			reused across runs. Every vertex is set to White first.
  * @tparam Graph graph type AdjacencyList or AdjacencyMatrix
  * @tparam Visitor type, DFSNullVisitor or TopoVisitor
+ * @tparam ColourMap property map from vertex index to DFSColour, e.g. VectorPropertyMap<DFSColour>
  * @param g graph to perform DFS on
  * @param visitor object descriping the behavior when traversing.
+ * @param colour map with a key for every vertex index, holds Black for every vertex afterwards.
  */
-template<typename Graph, typename Visitor>
-void dfs(const Graph &g, Visitor visitor) {
-	std::vector<graph::detail::DFSColour> colour_vec (numVertices(g));
-	for (auto v = vertices(g).begin(); v != vertices(g).end(); v++) {
-		colour_vec[*v] = graph::detail::DFSColour::White;
-		visitor.initVertex(v, g);
+template<typename Graph, typename Visitor, ReadWritePropertyMap<DFSColour> ColourMap>
+void dfs(const Graph &g, Visitor visitor, ColourMap &colour) {
+	GRAPH_PHASE("dfs");
+	{
+		GRAPH_PHASE("dfs/init");
+		for (auto v : vertices(g)) {
+			put(colour, getIndex(v, g), DFSColour::White);
+			visitor.initVertex(v, g);
+		}
 	}
-	for (auto v = vertices(g).begin(); v != vertices(g).end(); v++) {
-		if(colour_vec[*v] == graph::detail::DFSColour::White) {
+	for (auto v : vertices(g)) {
+		if(get(colour, getIndex(v, g)) == DFSColour::White) {
 			visitor.startVertex(v, g);
-			graph::detail::dfsVisit(g, visitor, *v, colour_vec);
+			graph::detail::dfsVisit(g, visitor, v, colour);
 		}
 	}
 }
 
+/**
+ * @brief DFS algorithm following the pseudo-code from the book Introduction to Algorithms and the Boost Graph library.
+ * @tparam Graph graph type AdjacencyList or AdjacencyMatrix
+ * @tparam Visitor type, DFSNullVisitor or TopoVisitor
+ * @param g graph to perform DFS on
+ * @param visitor object descriping the behavior when traversing.
+ */
+template<typename Graph, typename Visitor>
+void dfs(const Graph &g, Visitor visitor) {
+	TwoBitPropertyMap<DFSColour> colour(numVertices(g));
+	dfs(g, visitor, colour);
+}
+
+/**
+ * @brief DFS from the single vertex `start`, visiting only the vertices reachable from it.
+ * 			The colour map is not initialised, every vertex not yet visited must read as White.
+ * 			With a GenerationPropertyMap<DFSColour> that is cleared between calls, repeated
+ * 			traversals cost O(visited) instead of O(V).
+ * @param g graph to perform DFS on
+ * @param start vertex to start from, skipped if it is not White
+ * @param visitor object descriping the behavior when traversing, initVertex is not called.
+ * @param colour map with a key for every vertex index.
+ */
+template<typename Graph, typename Visitor, ReadWritePropertyMap<DFSColour> ColourMap>
+void dfsFrom(const Graph &g, typename Traits<Graph>::VertexDescriptor start, Visitor visitor, ColourMap &colour) {
+	if(get(colour, getIndex(start, g)) != DFSColour::White) return;
+	GRAPH_PHASE("dfsFrom");
+	visitor.startVertex(start, g);
+	graph::detail::dfsVisit(g, visitor, start, colour);
+}
+
 } // namespace graph
 
 #endif // GRAPH_DEPTH_FIRST_SEARCH_HPP
@@ -0,0 +1,124 @@
+#ifndef GRAPH_DIJKSTRA_SHORTEST_PATHS_HPP
+#define GRAPH_DIJKSTRA_SHORTEST_PATHS_HPP
+
+#include "edge_columns.hpp"
+#include "instrumentation.hpp"
+#include "property_map.hpp"
+#include "traits.hpp"
+#include <functional>
+#include <queue>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+struct DijkstraNullVisitor {
+	template<typename G, typename V>
+	void initVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void startVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void discoverVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void examineVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void finishVertex(const V&, const G&) { }
+
+	template<typename G, typename E>
+	void examineEdge(const E&, const G&) { }
+
+	template<typename G, typename E>
+	void edgeRelaxed(const E&, const G&) { }
+
+	template<typename G, typename E>
+	void edgeNotRelaxed(const E&, const G&) { }
+};
+
+namespace detail {
+
+// Distance type of dijkstra(), the type of the edge weights.
+template<typename Graph, typename WeightFn>
+using DijkstraDistance = std::decay_t<std::invoke_result_t<WeightFn&, const typename Traits<Graph>::EdgeDescriptor&>>;
+
+} // namespace detail
+
+/**
+ * @brief Single source shortest paths by Dijkstra's algorithm with a binary heap. Decrease-key is
+ * 			replaced by pushing the vertex again and skipping stale heap entries, so every vertex is
+ * 			examined and finished once. A vertex is discovered the first time an edge to it is relaxed.
+ * 			The distance map is not initialised, every vertex must read as infiniteDistance(); with a
+ * 			GenerationPropertyMap that is cleared between calls, repeated searches cost O(reached)
+ * 			instead of O(V).
+ * @param g graph to search
+ * @param start source vertex
+ * @param weight callable returning the non-negative weight of an edge descriptor
+ * @param visitor object descriping the behavior when searching, initVertex is not called.
+ * @param dist map with a key for every vertex index, holds the distance of every reached vertex afterwards.
+ */
+template<typename Graph, typename WeightFn, typename Visitor,
+         ReadWritePropertyMap<detail::DijkstraDistance<Graph, WeightFn>> DistMap>
+void dijkstra(const Graph &g, typename Traits<Graph>::VertexDescriptor start, WeightFn weight,
+              Visitor visitor, DistMap &dist) {
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	using D = detail::DijkstraDistance<Graph, WeightFn>;
+	using Entry = std::pair<D, Vertex>;
+	GRAPH_PHASE("dijkstra");
+	// ties are broken by vertex index
+	auto later = [&g](const Entry &a, const Entry &b) {
+		return a.first != b.first ? a.first > b.first : getIndex(a.second, g) > getIndex(b.second, g);
+	};
+	std::priority_queue<Entry, std::vector<Entry>, decltype(later)> heap(later);
+	visitor.startVertex(start, g);
+	put(dist, getIndex(start, g), D());
+	visitor.discoverVertex(start, g);
+	heap.emplace(D(), start);
+	while(!heap.empty()) {
+		const auto [d, u] = heap.top();
+		heap.pop();
+		if(d > get(dist, getIndex(u, g))) continue; // stale entry, the vertex is already finished
+		visitor.examineVertex(u, g);
+		for(auto e : outEdges(u, g)) {
+			visitor.examineEdge(e, g);
+			const auto v = target(e, g);
+			const std::size_t j = getIndex(v, g);
+			const D candidate = d + weight(e);
+			const D current = get(dist, j);
+			if(candidate < current) {
+				put(dist, j, candidate);
+				visitor.edgeRelaxed(e, g);
+				if(current == infiniteDistance<D>()) visitor.discoverVertex(v, g);
+				heap.emplace(candidate, v);
+			} else
+				visitor.edgeNotRelaxed(e, g);
+		}
+		visitor.finishVertex(u, g);
+	}
+}
+
+/**
+ * @brief Dijkstra from `start`, calling initVertex for every vertex first.
+ * @param g graph to search
+ * @param start source vertex
+ * @param weight callable returning the non-negative weight of an edge descriptor
+ * @param visitor object descriping the behavior when searching.
+ * @return the distance of every vertex by index, infiniteDistance() if it is not reachable.
+ */
+template<typename Graph, typename WeightFn, typename Visitor = DijkstraNullVisitor>
+auto dijkstra(const Graph &g, typename Traits<Graph>::VertexDescriptor start, WeightFn weight,
+              Visitor visitor = {}) {
+	using D = detail::DijkstraDistance<Graph, WeightFn>;
+	std::vector<D> dist(numVertices(g), infiniteDistance<D>());
+	for(auto v : vertices(g)) visitor.initVertex(v, g);
+	detail::VectorRefMap<D> map{&dist};
+	dijkstra(g, start, weight, visitor, map);
+	return dist;
+}
+
+} // namespace graph
+
+#endif // GRAPH_DIJKSTRA_SHORTEST_PATHS_HPP
@@ -0,0 +1,200 @@
+#ifndef GRAPH_DISTRIBUTED_HPP
+#define GRAPH_DISTRIBUTED_HPP
+
+#include "communicator.hpp"
+#include "instrumentation.hpp"
+#include "traits.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief The part of a graph owned by one rank.
+ * 			Local vertex ids [0, numOwned) are the owned vertices in increasing global order,
+ * 			ids [numOwned, globalId.size()) are ghosts: copies of the remote targets of owned vertices.
+ * 			The out edges of the owned vertices are stored as CSR over local ids, so an algorithm
+ * 			only needs the ghost tables to know where to send updates for remote targets.
+ */
+template<typename VertexDescriptor>
+struct Shard {
+	// Number of vertices with local ids, owned and ghosts.
+	std::size_t numLocal() const { return globalId.size(); }
+
+	bool isGhost(std::size_t local) const { return local >= numOwned; }
+
+	// Owning rank of ghost `local`.
+	std::size_t owner(std::size_t local) const { return ghostOwner[local - numOwned]; }
+
+	// Local id of ghost `local` on its owning rank.
+	std::size_t remoteId(std::size_t local) const { return ghostRemoteId[local - numOwned]; }
+
+	/**
+	 * @return the local id of the owned vertex `v`, or std::nullopt if another rank owns it.
+	 */
+	std::optional<std::size_t> localId(VertexDescriptor v) const {
+		auto last = globalId.begin() + numOwned;
+		auto it = std::lower_bound(globalId.begin(), last, v);
+		if(it == last || *it != v) return std::nullopt;
+		return static_cast<std::size_t>(it - globalId.begin());
+	}
+public:
+	std::size_t rank = 0;
+	std::size_t numOwned = 0;
+	std::vector<VertexDescriptor> globalId;
+	std::vector<std::size_t> ghostOwner;
+	std::vector<std::size_t> ghostRemoteId;
+	// out edges of owned vertex u are targets[offsets[u]] through targets[offsets[u + 1] - 1]
+	std::vector<std::size_t> offsets;
+	std::vector<std::size_t> targets;
+};
+
+/**
+ * @brief Splits `g` into one Shard per part, e.g. with the output of partition().
+ * @param g graph to split
+ * @param part the part in [0, numParts) of every vertex, indexed by getIndex()
+ * @param numParts number of shards to create
+ */
+template<typename Graph>
+std::vector<Shard<typename Traits<Graph>::VertexDescriptor>>
+shardGraph(const Graph &g, const std::vector<std::size_t> &part, std::size_t numParts) {
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+	std::vector<Shard<Vertex>> shards(numParts);
+	// local id of every vertex on its owner
+	std::vector<std::size_t> ownerLocal(numVertices(g));
+	for(auto v : vertices(g)) {
+		auto &s = shards[part[getIndex(v, g)]];
+		ownerLocal[getIndex(v, g)] = s.globalId.size();
+		s.globalId.push_back(v);
+	}
+	std::vector<std::size_t> ghostOf(numVertices(g), none);
+	std::vector<std::size_t> stamp(numVertices(g), none);
+	for(std::size_t p = 0; p < numParts; ++p) {
+		auto &s = shards[p];
+		s.rank = p;
+		s.numOwned = s.globalId.size();
+		s.offsets.assign(1, 0);
+		for(std::size_t u = 0; u < s.numOwned; ++u) {
+			for(auto e : outEdges(s.globalId[u], g)) {
+				const auto t = getIndex(target(e, g), g);
+				if(part[t] == p) {
+					s.targets.push_back(ownerLocal[t]);
+					continue;
+				}
+				if(stamp[t] != p) {
+					stamp[t] = p;
+					ghostOf[t] = s.globalId.size();
+					s.globalId.push_back(target(e, g));
+					s.ghostOwner.push_back(part[t]);
+					s.ghostRemoteId.push_back(ownerLocal[t]);
+				}
+				s.targets.push_back(ghostOf[t]);
+			}
+			s.offsets.push_back(s.targets.size());
+		}
+	}
+	return shards;
+}
+
+/**
+ * @brief Level-synchronous BFS over the out edges of a sharded graph. In every superstep each rank
+ * 			expands its local frontier, batches the newly reached ghosts per owning rank (every ghost
+ * 			is sent at most once), and exchanges the batches; the search stops when no rank has a frontier.
+ * @param shard the shard of this rank
+ * @param comm communicator of this rank
+ * @param start global vertex to start from
+ * @return the hop distance of every owned vertex, or std::numeric_limits<std::size_t>::max() if unreachable.
+ */
+template<typename VertexDescriptor>
+std::vector<std::size_t> distributedBfs(const Shard<VertexDescriptor> &shard, Communicator &comm,
+                                        VertexDescriptor start) {
+	GRAPH_PHASE("distributedBfs");
+	constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+	std::vector<std::size_t> dist(shard.numOwned, inf);
+	std::vector<char> ghostSent(shard.numLocal() - shard.numOwned, false);
+	std::vector<std::size_t> frontier, next;
+	if(auto s = shard.localId(start)) {
+		dist[*s] = 0;
+		frontier.push_back(*s);
+	}
+	for(std::size_t level = 0; comm.allReduceSum<std::uint64_t>(frontier.size()) > 0; ++level) {
+		std::vector<std::vector<std::uint64_t>> outgoing(comm.size());
+		next.clear();
+		for(auto u : frontier) {
+			for(std::size_t i = shard.offsets[u]; i < shard.offsets[u + 1]; ++i) {
+				const std::size_t t = shard.targets[i];
+				if(!shard.isGhost(t)) {
+					if(dist[t] != inf) continue;
+					dist[t] = level + 1;
+					next.push_back(t);
+				} else if(!ghostSent[t - shard.numOwned]) {
+					ghostSent[t - shard.numOwned] = true;
+					outgoing[shard.owner(t)].push_back(shard.remoteId(t));
+				}
+			}
+		}
+		for(const auto &batch : comm.exchange(std::move(outgoing))) {
+			for(auto t : batch) {
+				if(dist[t] != inf) continue;
+				dist[t] = level + 1;
+				next.push_back(t);
+			}
+		}
+		std::swap(frontier, next);
+	}
+	return dist;
+}
+
+/**
+ * @brief Push-based PageRank on a sharded graph. In every superstep each rank pushes the rank of its
+ * 			owned vertices along their out edges, sums the contributions to each ghost locally, and
+ * 			sends one (remote id, sum) pair per ghost to its owner. The rank of dangling vertices is
+ * 			spread uniformly via a global sum.
+ * @param shard the shard of this rank
+ * @param comm communicator of this rank
+ * @param iterations number of supersteps
+ * @param damping damping factor
+ * @return the PageRank of every owned vertex; the ranks of all vertices sum to 1.
+ */
+template<typename VertexDescriptor>
+std::vector<double> distributedPageRank(const Shard<VertexDescriptor> &shard, Communicator &comm,
+                                        std::size_t iterations, double damping = 0.85) {
+	GRAPH_PHASE("distributedPageRank");
+	struct Update {
+		std::uint64_t id;
+		double value;
+	};
+	const double n = static_cast<double>(comm.allReduceSum<std::uint64_t>(shard.numOwned));
+	std::vector<double> rank(shard.numOwned, 1 / n), contrib(shard.numLocal());
+	for(std::size_t it = 0; it < iterations; ++it) {
+		std::fill(contrib.begin(), contrib.end(), 0.0);
+		double dangling = 0;
+		for(std::size_t u = 0; u < shard.numOwned; ++u) {
+			const std::size_t deg = shard.offsets[u + 1] - shard.offsets[u];
+			if(deg == 0) {
+				dangling += rank[u];
+				continue;
+			}
+			const double share = rank[u] / static_cast<double>(deg);
+			for(std::size_t i = shard.offsets[u]; i < shard.offsets[u + 1]; ++i) contrib[shard.targets[i]] += share;
+		}
+		std::vector<std::vector<Update>> outgoing(comm.size());
+		for(std::size_t t = shard.numOwned; t < shard.numLocal(); ++t)
+			outgoing[shard.owner(t)].push_back(Update{shard.remoteId(t), contrib[t]});
+		for(const auto &batch : comm.exchange(std::move(outgoing)))
+			for(const Update &up : batch) contrib[up.id] += up.value;
+		dangling = comm.allReduceSum(dangling);
+		for(std::size_t u = 0; u < shard.numOwned; ++u)
+			rank[u] = (1 - damping) / n + damping * (contrib[u] + dangling / n);
+	}
+	return rank;
+}
+
+} // namespace graph
+
+#endif // GRAPH_DISTRIBUTED_HPP
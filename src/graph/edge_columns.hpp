@@ -0,0 +1,175 @@
+#ifndef GRAPH_EDGE_COLUMNS_HPP
+#define GRAPH_EDGE_COLUMNS_HPP
+
+#include "instrumentation.hpp"
+#include "properties.hpp"
+#include "traits.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <limits>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace graph {
+namespace detail {
+
+template<typename Class, typename T>
+T memberType(T Class::*);
+
+// Type of the data member `Member` points to.
+template<auto Member>
+using MemberType = decltype(memberType(Member));
+
+} // namespace detail
+
+/**
+ * @brief Structure-of-arrays copy of the edges of a graph: the sources, the targets and every
+ * 			registered field of the EdgeProp each live in their own contiguous column, so a kernel
+ * 			reading one field only streams that field. Fields are registered as pointers to data
+ * 			members, e.g. EdgeColumns<Graph, &Road::length, &Road::lanes>; without any members
+ * 			the whole EdgeProp forms a single column (useful for scalar props such as a weight).
+ * 			Position i of every column belongs to the i-th edge of edges(g).
+ */
+template<typename Graph, auto... Members>
+class EdgeColumns {
+	using EdgeProp = typename Traits<Graph>::EdgeProp;
+	static constexpr bool wholeProp = sizeof...(Members) == 0 && detail::hasEdgeProp<Graph>;
+	using Columns = std::conditional_t<wholeProp,
+		std::tuple<std::vector<EdgeProp>>,
+		std::tuple<std::vector<detail::MemberType<Members>>...>>;
+public:
+	/**
+	 * @brief Copies the edges of `g` into columns.
+	 * @param g an EdgeListGraph, a PropertyGraph if any column is requested
+	 */
+	explicit EdgeColumns(const Graph &g) {
+		const std::size_t m = numEdges(g);
+		src.reserve(m);
+		tar.reserve(m);
+		std::apply([m](auto &...col) { (col.reserve(m), ...); }, columns);
+		for(auto e : edges(g)) {
+			src.push_back(getIndex(source(e, g), g));
+			tar.push_back(getIndex(target(e, g), g));
+			if constexpr(wholeProp) {
+				std::get<0>(columns).push_back(g[e]);
+			} else {
+				const auto &prop = g[e];
+				pushMembers(prop, std::index_sequence_for<decltype(Members)...>{});
+			}
+		}
+	}
+
+	std::size_t size() const { return src.size(); }
+
+	// Index of the source vertex of every edge.
+	std::span<const std::size_t> sources() const { return src; }
+
+	// Index of the target vertex of every edge.
+	std::span<const std::size_t> targets() const { return tar; }
+
+	/**
+	 * @return the I-th registered column.
+	 */
+	template<std::size_t I>
+	auto column() { return std::span(std::get<I>(columns)); }
+
+	template<std::size_t I>
+	auto column() const { return std::span(std::as_const(std::get<I>(columns))); }
+
+	/**
+	 * @return the column of the registered member `Member`.
+	 */
+	template<auto Member>
+	auto column() requires std::is_member_object_pointer_v<decltype(Member)> {
+		return column<indexOf<Member>()>();
+	}
+
+	template<auto Member>
+	auto column() const requires std::is_member_object_pointer_v<decltype(Member)> {
+		return column<indexOf<Member>()>();
+	}
+private:
+	template<std::size_t... I>
+	void pushMembers(const EdgeProp &prop, std::index_sequence<I...>) {
+		(std::get<I>(columns).push_back(prop.*Members), ...);
+	}
+
+	template<auto A, auto B>
+	static constexpr bool sameMember() {
+		if constexpr(std::is_same_v<decltype(A), decltype(B)>) return A == B;
+		else return false;
+	}
+
+	template<auto Member>
+	static constexpr std::size_t indexOf() {
+		constexpr std::array<bool, sizeof...(Members)> same = {sameMember<Member, Members>()...};
+		constexpr std::size_t i = std::find(same.begin(), same.end(), true) - same.begin();
+		static_assert(i < sizeof...(Members), "member is not registered");
+		return i;
+	}
+private:
+	std::vector<std::size_t> src, tar;
+	Columns columns;
+};
+
+/**
+ * @return the distance used for unreached vertices: infinity if `D` has one, its maximum otherwise.
+ */
+template<typename D>
+constexpr D infiniteDistance() {
+	if constexpr(std::numeric_limits<D>::has_infinity) return std::numeric_limits<D>::infinity();
+	else return std::numeric_limits<D>::max();
+}
+
+/**
+ * @brief One Bellman-Ford sweep over edge columns: dist[tar[i]] = min(dist[tar[i]], dist[src[i]] + weight[i]).
+ * 			The edges are processed in blocks; the candidate distances of a block are computed in a
+ * 			branch-free loop the compiler can vectorise (a gather, an add and a blend), and only the
+ * 			scatter of the minima stays sequential.
+ * @param src source index of every edge, e.g. EdgeColumns::sources()
+ * @param tar target index of every edge, e.g. EdgeColumns::targets()
+ * @param weight contiguous range with the weight of every edge, e.g. an EdgeColumns column
+ * @param dist current distance of every vertex, infiniteDistance<D>() if unreached
+ * @return true if any distance decreased. Throws std::invalid_argument if `src`, `tar` and `weight`
+ * 			differ in size.
+ */
+template<std::ranges::contiguous_range Weights, typename D>
+bool relaxEdges(std::span<const std::size_t> src, std::span<const std::size_t> tar,
+                const Weights &weight, std::vector<D> &dist) {
+	using W = std::ranges::range_value_t<Weights>;
+	GRAPH_PHASE("relaxEdges");
+	if(std::ranges::size(weight) != src.size() || tar.size() != src.size())
+		throw std::invalid_argument("relaxEdges: src, tar and weight must have the same size");
+	constexpr std::size_t blockSize = 256;
+	constexpr D inf = infiniteDistance<D>();
+	std::array<D, blockSize> candidate;
+	bool changed = false;
+	for(std::size_t first = 0; first < src.size(); first += blockSize) {
+		const std::size_t len = std::min(blockSize, src.size() - first);
+		const std::size_t *s = src.data() + first;
+		const W *w = std::ranges::data(weight) + first;
+		for(std::size_t i = 0; i < len; ++i) {
+			const D ds = dist[s[i]];
+			candidate[i] = ds == inf ? inf : static_cast<D>(ds + w[i]);
+		}
+		const std::size_t *t = tar.data() + first;
+		for(std::size_t i = 0; i < len; ++i) {
+			if(candidate[i] < dist[t[i]]) {
+				dist[t[i]] = candidate[i];
+				changed = true;
+			}
+		}
+	}
+	return changed;
+}
+
+} // namespace graph
+
+#endif // GRAPH_EDGE_COLUMNS_HPP
@@ -0,0 +1,129 @@
+#ifndef GRAPH_EDGE_INDEX_HPP
+#define GRAPH_EDGE_INDEX_HPP
+
+#include "traits.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Read-only lookup structure answering `edge(src, tar, index)` for an IncidenceGraph.
+ * 			The out edges of every vertex are stored contiguously in one array.
+ * 			Vertices with at most `hashThreshold` out edges keep them sorted by target
+ * 			and are searched with binary search, while vertices with more out edges get
+ * 			an open-addressing hash table (linear probing) so hubs are answered in O(1).
+ * 			The index is a snapshot: it must be rebuilt after edges are added to the graph.
+ * @tparam Graph graph type AdjacencyList or AdjacencyMatrix
+ */
+template<typename Graph>
+struct EdgeIndex {
+	using VertexDescriptor = typename Traits<Graph>::VertexDescriptor;
+	using EdgeDescriptor = typename Traits<Graph>::EdgeDescriptor;
+private:
+	static constexpr std::size_t emptySlot = std::numeric_limits<std::size_t>::max();
+
+	/**
+	 * @brief An out edge together with the index of its target, used both as a sorted entry
+	 * 			and as a hash slot. Empty hash slots have `tar == emptySlot`.
+	 */
+	struct Entry {
+		std::size_t tar = emptySlot;
+		EdgeDescriptor e;
+	};
+public:
+	/**
+	 * @param g graph to index, must outlive the index.
+	 * @param hashThreshold vertices with a larger out degree are hashed instead of sorted.
+	 */
+	EdgeIndex(const Graph &g, std::size_t hashThreshold = 32) : g(&g) {
+		const std::size_t n = numVertices(g);
+		offsets.reserve(n + 1);
+		hashed.reserve(n);
+		offsets.push_back(0);
+		for(auto v : vertices(g)) {
+			const std::size_t deg = outDegree(v, g);
+			const bool useHash = deg > hashThreshold;
+			// keep the load factor at or below 1/2
+			const std::size_t size = useHash ? std::bit_ceil(2 * deg) : deg;
+			hashed.push_back(useHash);
+			offsets.push_back(offsets.back() + size);
+		}
+		entries.resize(offsets.back());
+
+		for(auto v : vertices(g)) {
+			const auto idx = getIndex(v, g);
+			Entry *first = entries.data() + offsets[idx];
+			const std::size_t size = offsets[idx + 1] - offsets[idx];
+			if(hashed[idx]) {
+				for(auto e : outEdges(v, g)) {
+					const std::size_t tar = getIndex(target(e, g), g);
+					Entry *slot = probe(first, size, tar);
+					// keep the first added edge for multigraphs
+					if(slot->tar == emptySlot) *slot = Entry{tar, e};
+				}
+			} else {
+				Entry *last = first;
+				for(auto e : outEdges(v, g))
+					*last++ = Entry{getIndex(target(e, g), g), e};
+				// stable, so lower_bound finds the first added edge for multigraphs
+				std::stable_sort(first, last, [](const Entry &a, const Entry &b) {
+					return a.tar < b.tar;
+				});
+			}
+		}
+	}
+
+	/**
+	 * @param src vertex descriptor of the source vertex
+	 * @param tar vertex descriptor of the target vertex
+	 * @param index the index to search
+	 * @return the first added edge from `src` to `tar`, or std::nullopt if there is none.
+	 */
+	friend std::optional<EdgeDescriptor> edge(VertexDescriptor src, VertexDescriptor tar,
+	                                          const EdgeIndex &index) {
+		const auto idx = getIndex(src, *index.g);
+		const std::size_t key = getIndex(tar, *index.g);
+		const Entry *first = index.entries.data() + index.offsets[idx];
+		const std::size_t size = index.offsets[idx + 1] - index.offsets[idx];
+		if(index.hashed[idx]) {
+			const Entry *slot = probe(first, size, key);
+			if(slot->tar == emptySlot) return std::nullopt;
+			return slot->e;
+		}
+		const Entry *last = first + size;
+		const Entry *it = std::lower_bound(first, last, key, [](const Entry &a, std::size_t k) {
+			return a.tar < k;
+		});
+		if(it == last || it->tar != key) return std::nullopt;
+		return it->e;
+	}
+private:
+	/**
+	 * @brief Linear probing in a power of two sized table (at least 2 slots) which is never full.
+	 * @return the slot holding `key`, or the empty slot where it would be inserted.
+	 */
+	template<typename EntryT>
+	static EntryT *probe(EntryT *table, std::size_t size, std::size_t key) {
+		const std::size_t mask = size - 1;
+		// Fibonacci hashing spreads consecutive vertex indices over the table
+		std::size_t i = (static_cast<std::uint64_t>(key) * 0x9E3779B97F4A7C15ull) >> (64 - std::countr_zero(size));
+		while(table[i].tar != emptySlot && table[i].tar != key)
+			i = (i + 1) & mask;
+		return table + i;
+	}
+private:
+	const Graph *g;
+	std::vector<std::size_t> offsets;
+	std::vector<bool> hashed;
+	std::vector<Entry> entries;
+};
+
+} // namespace graph
+
+#endif // GRAPH_EDGE_INDEX_HPP
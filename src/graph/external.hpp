@@ -0,0 +1,331 @@
+#ifndef GRAPH_EXTERNAL_HPP
+#define GRAPH_EXTERNAL_HPP
+
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "traits.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <memory>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Binary adjacency file layout, all integers little endian as written by the host:
+//
+// - an 8 byte magic "GRAPHADJ", the number of vertices n and of edges m as uint64,
+// - n + 1 uint64 offsets, the out edges of vertex v are entries offsets[v] to offsets[v + 1] - 1,
+// - zero padding up to the next multiple of 4096 bytes, so the edges can be read with O_DIRECT,
+// - m uint32 edge targets, grouped by source.
+namespace detail {
+
+inline constexpr char adjacencyMagic[8] = {'G', 'R', 'A', 'P', 'H', 'A', 'D', 'J'};
+inline constexpr std::size_t ioAlignment = 4096;
+
+inline std::size_t alignUp(std::size_t x, std::size_t a) {
+	return (x + a - 1) / a * a;
+}
+
+inline std::size_t targetsOffset(std::size_t n) {
+	return alignUp(sizeof(adjacencyMagic) + 2 * sizeof(std::uint64_t) + (n + 1) * sizeof(std::uint64_t), ioAlignment);
+}
+
+/**
+ * @brief Writes a binary adjacency file with the given offsets, the targets are produced in order
+ * 			by `forEachTarget(emit)`, which calls `emit(tar)` once per edge.
+ */
+template<typename ForEachTarget>
+void writeBinaryAdjacency(const std::vector<std::uint64_t> &offsets, const std::string &path,
+                          ForEachTarget forEachTarget) {
+	const std::uint64_t n = offsets.size() - 1;
+	if(n >= std::numeric_limits<std::uint32_t>::max())
+		throw std::runtime_error("writeBinaryAdjacency: too many vertices for 32 bit targets");
+	const std::uint64_t m = offsets.back();
+
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	if(!out) throw std::runtime_error("writeBinaryAdjacency: cannot open " + path);
+	out.write(adjacencyMagic, sizeof(adjacencyMagic));
+	out.write(reinterpret_cast<const char*>(&n), sizeof(n));
+	out.write(reinterpret_cast<const char*>(&m), sizeof(m));
+	out.write(reinterpret_cast<const char*>(offsets.data()), offsets.size() * sizeof(std::uint64_t));
+	const std::size_t header = sizeof(adjacencyMagic) + 2 * sizeof(std::uint64_t) + offsets.size() * sizeof(std::uint64_t);
+	const std::vector<char> padding(targetsOffset(n) - header, 0);
+	out.write(padding.data(), padding.size());
+
+	std::vector<std::uint32_t> buffer;
+	buffer.reserve(1 << 16);
+	auto flush = [&] {
+		out.write(reinterpret_cast<const char*>(buffer.data()), buffer.size() * sizeof(std::uint32_t));
+		buffer.clear();
+	};
+	forEachTarget([&](std::size_t tar) {
+		buffer.push_back(static_cast<std::uint32_t>(tar));
+		if(buffer.size() == buffer.capacity()) flush();
+	});
+	flush();
+	if(!out) throw std::runtime_error("writeBinaryAdjacency: failed writing " + path);
+}
+
+} // namespace detail
+
+/**
+ * @brief Writes the out edges of `g` to `path` in the binary adjacency format read by SemiExternalGraph.
+ * 			Throws std::runtime_error if the file cannot be written or `g` has 2^32 or more vertices.
+ */
+template<typename Graph>
+void writeBinaryAdjacency(const Graph &g, const std::string &path) {
+	std::vector<std::uint64_t> offsets(numVertices(g) + 1, 0);
+	for(auto v : vertices(g)) offsets[getIndex(v, g) + 1] = outDegree(v, g);
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+	detail::writeBinaryAdjacency(offsets, path, [&](auto emit) {
+		for(auto v : vertices(g))
+			for(auto e : outEdges(v, g)) emit(getIndex(target(e, g), g));
+	});
+}
+
+/**
+ * @brief Writes the edges (src, tar) over the vertices [0, n) to `path` in the binary adjacency format,
+ * 			e.g. straight from a generator. The edges are grouped by source with a parallel counting sort.
+ */
+inline void writeBinaryAdjacency(std::size_t n, const std::vector<std::pair<std::size_t, std::size_t>> &pairs,
+                                 const std::string &path) {
+	const auto bySource = detail::countingSort(pairs, n, [](const auto &p) { return p.first; });
+	std::vector<std::uint64_t> offsets(n + 1, 0);
+	for(const auto &p : pairs) ++offsets[p.first + 1];
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+	detail::writeBinaryAdjacency(offsets, path, [&](auto emit) {
+		for(const auto &p : bySource) emit(p.second);
+	});
+}
+
+/**
+ * @brief Options for SemiExternalGraph.
+ */
+struct ExternalOptions {
+	// bytes per read, rounded up to a multiple of 4096
+	std::size_t blockSize = std::size_t(1) << 22;
+	// bypass the page cache with O_DIRECT, falls back to buffered reads if the file system refuses
+	bool directIO = false;
+};
+
+/**
+ * @brief Semi-external graph: the O(n) offsets array is kept in memory while the O(m) edge targets
+ * 			stay in a binary adjacency file (see writeBinaryAdjacency()) and are streamed by scanEdges().
+ * 			Every scan is one sequential pass over the file using large aligned reads into two buffers,
+ * 			the next block being read on another thread while the current one is processed.
+ */
+class SemiExternalGraph {
+public:
+	using VertexDescriptor = std::size_t;
+
+	SemiExternalGraph(const std::string &path, ExternalOptions opts = {})
+		: blockSize(detail::alignUp(std::max<std::size_t>(opts.blockSize, 1), detail::ioAlignment)) {
+		std::ifstream in(path, std::ios::binary);
+		char magic[sizeof(detail::adjacencyMagic)];
+		std::uint64_t header[2];
+		if(!in.read(magic, sizeof(magic)) || std::memcmp(magic, detail::adjacencyMagic, sizeof(magic)) != 0)
+			throw std::runtime_error("SemiExternalGraph: " + path + " is not a binary adjacency file");
+		if(!in.read(reinterpret_cast<char*>(header), sizeof(header)))
+			throw std::runtime_error("SemiExternalGraph: truncated header in " + path);
+		n = header[0];
+		m = header[1];
+		if(n >= std::numeric_limits<std::uint32_t>::max())
+			throw std::runtime_error("SemiExternalGraph: too many vertices in " + path);
+		offsets.resize(n + 1);
+		if(!in.read(reinterpret_cast<char*>(offsets.data()), offsets.size() * sizeof(std::uint64_t)))
+			throw std::runtime_error("SemiExternalGraph: truncated offsets in " + path);
+		// scanEdges() walks the offsets to find the source of every edge
+		if(offsets[0] != 0 || offsets[n] != m || !std::is_sorted(offsets.begin(), offsets.end()))
+			throw std::runtime_error("SemiExternalGraph: corrupt offsets in " + path);
+
+		if(opts.directIO) fd = ::open(path.c_str(), O_RDONLY | O_DIRECT);
+		if(fd < 0) fd = ::open(path.c_str(), O_RDONLY);
+		if(fd < 0) throw std::runtime_error("SemiExternalGraph: cannot open " + path + ": " + std::strerror(errno));
+#ifdef POSIX_FADV_SEQUENTIAL
+		::posix_fadvise(fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+#endif
+	}
+
+	SemiExternalGraph(const SemiExternalGraph&) = delete;
+	SemiExternalGraph &operator=(const SemiExternalGraph&) = delete;
+
+	~SemiExternalGraph() {
+		if(fd >= 0) ::close(fd);
+	}
+private:
+	struct FreeDeleter {
+		void operator()(void *p) const { std::free(p); }
+	};
+	using Buffer = std::unique_ptr<char, FreeDeleter>;
+
+	Buffer allocateBuffer() const {
+		void *p = nullptr;
+		if(::posix_memalign(&p, detail::ioAlignment, blockSize) != 0) throw std::bad_alloc();
+		return Buffer(static_cast<char*>(p));
+	}
+
+	/**
+	 * @brief Reads the aligned block starting at file offset `pos`, short only at the end of the file.
+	 * @return the number of bytes read.
+	 */
+	std::size_t readBlock(char *buf, std::size_t pos) const {
+		std::size_t done = 0;
+		while(done < blockSize) {
+			const ssize_t k = ::pread(fd, buf + done, blockSize - done, static_cast<off_t>(pos + done));
+			if(k < 0 && errno == EINTR) continue;
+			if(k < 0) throw std::runtime_error(std::string("SemiExternalGraph: read failed: ") + std::strerror(errno));
+			if(k == 0) break;
+			done += static_cast<std::size_t>(k);
+			// O_DIRECT requires aligned offsets, so a short read can only be continued at the end of the file
+			if(done % detail::ioAlignment != 0) break;
+		}
+		return done;
+	}
+private:
+	std::size_t n = 0, m = 0;
+	std::vector<std::uint64_t> offsets;
+	std::size_t blockSize;
+	int fd = -1;
+	mutable std::size_t numPasses = 0;
+public:
+	friend std::size_t numVertices(const SemiExternalGraph &g) {
+		return g.n;
+	}
+
+	friend std::size_t numEdges(const SemiExternalGraph &g) {
+		return g.m;
+	}
+
+	friend std::size_t outDegree(std::size_t v, const SemiExternalGraph &g) {
+		return g.offsets[v + 1] - g.offsets[v];
+	}
+
+	friend std::size_t getIndex(std::size_t v, const SemiExternalGraph &) {
+		return v;
+	}
+
+	// Number of scanEdges() passes made so far.
+	friend std::size_t numPasses(const SemiExternalGraph &g) {
+		return g.numPasses;
+	}
+
+	/**
+	 * @brief One sequential pass over the edge file, calling `f(src, tar)` for every edge grouped by source.
+	 * 			Throws std::runtime_error if the file is truncated or a target is not a vertex.
+	 */
+	template<typename F>
+	friend void scanEdges(const SemiExternalGraph &g, F f) {
+		++g.numPasses;
+		if(g.m == 0) return;
+		const std::size_t first = detail::targetsOffset(g.n);
+		const std::size_t last = first + g.m * sizeof(std::uint32_t);
+		Buffer current = g.allocateBuffer(), next = g.allocateBuffer();
+		std::size_t currentBytes = g.readBlock(current.get(), first);
+		std::size_t edge = 0, src = 0;
+		for(std::size_t pos = first; pos < last; pos += g.blockSize) {
+			std::future<std::size_t> prefetch;
+			if(pos + g.blockSize < last)
+				prefetch = std::async(std::launch::async, [&, p = pos + g.blockSize] { return g.readBlock(next.get(), p); });
+			const std::size_t usable = std::min(currentBytes, last - pos) / sizeof(std::uint32_t);
+			const std::uint32_t *targets = reinterpret_cast<const std::uint32_t*>(current.get());
+			for(std::size_t i = 0; i < usable; ++i, ++edge) {
+				while(g.offsets[src + 1] <= edge) ++src;
+				if(targets[i] >= g.n) throw std::runtime_error("SemiExternalGraph: edge target out of range");
+				f(src, static_cast<std::size_t>(targets[i]));
+			}
+			if(prefetch.valid()) {
+				currentBytes = prefetch.get();
+				std::swap(current, next);
+			}
+		}
+		if(edge != g.m) throw std::runtime_error("SemiExternalGraph: edge file is truncated");
+	}
+};
+
+/**
+ * @brief Semi-external BFS: every pass relaxes all edges in file order, dist[t] = min(dist[t], dist[s] + 1),
+ * 			which yields exact hop distances after at most (eccentricity of `start`) + 1 passes,
+ * 			often fewer as a pass can advance several levels along the file order.
+ * @return the hop distance of every vertex, std::numeric_limits<std::size_t>::max() if unreachable.
+ */
+inline std::vector<std::size_t> externalBfs(const SemiExternalGraph &g, std::size_t start) {
+	GRAPH_PHASE("externalBfs");
+	constexpr std::size_t inf = std::numeric_limits<std::size_t>::max();
+	std::vector<std::size_t> dist(numVertices(g), inf);
+	dist[start] = 0;
+	for(bool changed = true; changed;) {
+		changed = false;
+		scanEdges(g, [&](std::size_t s, std::size_t t) {
+			if(dist[s] != inf && dist[s] + 1 < dist[t]) {
+				dist[t] = dist[s] + 1;
+				changed = true;
+			}
+		});
+	}
+	return dist;
+}
+
+/**
+ * @brief Weakly connected components with an in-memory union-find, in a single pass over the edges.
+ * @return the component of every vertex, labelled by its lowest vertex index.
+ */
+inline std::vector<std::size_t> externalConnectedComponents(const SemiExternalGraph &g) {
+	GRAPH_PHASE("externalConnectedComponents");
+	std::vector<std::size_t> parent(numVertices(g));
+	std::iota(parent.begin(), parent.end(), 0);
+	auto find = [&](std::size_t v) {
+		while(parent[v] != v) {
+			parent[v] = parent[parent[v]];
+			v = parent[v];
+		}
+		return v;
+	};
+	scanEdges(g, [&](std::size_t s, std::size_t t) {
+		const std::size_t a = find(s), b = find(t);
+		// linking the larger root under the smaller keeps the lowest index as representative
+		if(a < b) parent[b] = a;
+		else if(b < a) parent[a] = b;
+	});
+	for(std::size_t v = 0; v < parent.size(); ++v) parent[v] = find(v);
+	return parent;
+}
+
+/**
+ * @brief PageRank with one pass over the edges per iteration; the rank of dangling vertices is spread uniformly.
+ * @return the PageRank of every vertex, summing to 1.
+ */
+inline std::vector<double> externalPageRank(const SemiExternalGraph &g, std::size_t iterations, double damping = 0.85) {
+	GRAPH_PHASE("externalPageRank");
+	const std::size_t n = numVertices(g);
+	std::vector<double> rank(n, 1.0 / static_cast<double>(n)), next(n);
+	for(std::size_t it = 0; it < iterations; ++it) {
+		double dangling = 0;
+		for(std::size_t v = 0; v < n; ++v)
+			if(outDegree(v, g) == 0) dangling += rank[v];
+		std::fill(next.begin(), next.end(), 0.0);
+		scanEdges(g, [&](std::size_t s, std::size_t t) {
+			next[t] += rank[s] / static_cast<double>(outDegree(s, g));
+		});
+		for(std::size_t v = 0; v < n; ++v)
+			rank[v] = (1 - damping) / static_cast<double>(n) + damping * (next[v] + dangling / static_cast<double>(n));
+	}
+	return rank;
+}
+
+} // namespace graph
+
+#endif // GRAPH_EXTERNAL_HPP
@@ -0,0 +1,177 @@
+#ifndef GRAPH_FILTERED_GRAPH_HPP
+#define GRAPH_FILTERED_GRAPH_HPP
+
+#include "tags.hpp"
+#include "traits.hpp"
+
+#include <boost/iterator/filter_iterator.hpp>
+
+#include <concepts>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+namespace graph {
+
+// Predicate accepting every vertex or edge, the default vertex predicate of filteredGraph().
+struct KeepAll {
+	template<typename T>
+	bool operator()(const T&) const { return true; }
+};
+
+namespace detail {
+
+/**
+ * @brief Range wrapping another range, skipping the elements for which `Pred` returns false.
+ * @tparam BaseRange the underlying range type, e.g. an OutEdgeRange
+ * @tparam Pred default constructible predicate on the value type of BaseRange
+ */
+template<typename BaseRange, typename Pred>
+struct FilteredRange {
+	using iterator = boost::filter_iterator<Pred, typename BaseRange::iterator>;
+public:
+	FilteredRange(BaseRange base, Pred pred) : base(base), pred(pred) {}
+
+	iterator begin() const { return iterator(pred, base.begin(), base.end()); }
+	iterator end()   const { return iterator(pred, base.end(), base.end()); }
+private:
+	BaseRange base;
+	Pred pred;
+};
+
+} // namespace detail
+
+/**
+ * @brief Zero-copy view of a graph which hides the edges for which `EdgePred` returns false
+ * 			and the vertices (and their incident edges) for which `VertexPred` returns false.
+ * 			The predicates are called as `edgePred(e)` and `vertexPred(v)` with descriptors of the
+ * 			underlying graph, which are also the descriptors of the view.
+ * 			As in the Boost Graph Library, numVertices() and numEdges() report the sizes of the
+ * 			underlying graph, so getIndex() stays a valid index into arrays of numVertices() entries.
+ * 			Copies of the view are cheap and share the predicates; ranges obtained from a view stay
+ * 			valid as long as the view or a copy of it is alive.
+ * @tparam Graph the underlying graph type, which must outlive the view
+ * @tparam EdgePred predicate on EdgeDescriptor
+ * @tparam VertexPred predicate on VertexDescriptor
+ */
+template<typename Graph, typename EdgePred, typename VertexPred = KeepAll>
+struct FilteredGraph {
+public: // Graph
+	using VertexDescriptor = typename Traits<Graph>::VertexDescriptor;
+	using EdgeDescriptor = typename Traits<Graph>::EdgeDescriptor;
+	using DirectedCategory = typename Traits<Graph>::DirectedCategory;
+public: // PropertyGraph
+	using VertexProp = typename Traits<Graph>::VertexProp;
+	using EdgeProp = typename Traits<Graph>::EdgeProp;
+private:
+	// The predicates are shared between copies of the view, so the filters can point to them
+	// and stay copy assignable even if the predicates (e.g. capturing lambdas) are not.
+	struct Predicates {
+		EdgePred edge;
+		VertexPred vertex;
+	};
+
+	struct VertexFilter {
+		bool operator()(const VertexDescriptor &v) const { return preds->vertex(v); }
+		const Predicates *preds = nullptr;
+	};
+
+	struct EdgeFilter {
+		bool operator()(const EdgeDescriptor &e) const {
+			return preds->edge(e) && preds->vertex(source(e, *g)) && preds->vertex(target(e, *g));
+		}
+		const Graph *g = nullptr;
+		const Predicates *preds = nullptr;
+	};
+
+	static constexpr bool bidirectional =
+		std::derived_from<DirectedCategory, graph::tags::Bidirectional>;
+public: // VertexListGraph, EdgeListGraph, IncidenceGraph and BidirectionalGraph
+	using VertexRange = detail::FilteredRange<typename Traits<Graph>::VertexRange, VertexFilter>;
+	using EdgeRange = detail::FilteredRange<typename Traits<Graph>::EdgeRange, EdgeFilter>;
+	using OutEdgeRange = detail::FilteredRange<typename Traits<Graph>::OutEdgeRange, EdgeFilter>;
+	// only a range if the underlying graph is bidirectional
+	using InEdgeRange = std::conditional_t<bidirectional,
+		detail::FilteredRange<typename Traits<Graph>::InEdgeRange, EdgeFilter>, void>;
+public:
+	FilteredGraph(const Graph &g, EdgePred edgePred, VertexPred vertexPred)
+		: g(&g), preds(std::make_shared<const Predicates>(Predicates{std::move(edgePred), std::move(vertexPred)})) {}
+private:
+	VertexFilter vertexFilter() const { return VertexFilter{preds.get()}; }
+	EdgeFilter edgeFilter() const { return EdgeFilter{g, preds.get()}; }
+private:
+	const Graph *g;
+	std::shared_ptr<const Predicates> preds;
+public: // Graph
+	friend VertexDescriptor source(const EdgeDescriptor &e, const FilteredGraph &fg) {
+		return source(e, *fg.g);
+	}
+
+	friend VertexDescriptor target(const EdgeDescriptor &e, const FilteredGraph &fg) {
+		return target(e, *fg.g);
+	}
+public: // VertexListGraph
+	friend std::size_t numVertices(const FilteredGraph &fg) {
+		return numVertices(*fg.g);
+	}
+
+	friend VertexRange vertices(const FilteredGraph &fg) {
+		return VertexRange(vertices(*fg.g), fg.vertexFilter());
+	}
+public: // EdgeListGraph
+	friend std::size_t numEdges(const FilteredGraph &fg) {
+		return numEdges(*fg.g);
+	}
+
+	friend EdgeRange edges(const FilteredGraph &fg) {
+		return EdgeRange(edges(*fg.g), fg.edgeFilter());
+	}
+public: // IncidenceGraph
+	friend OutEdgeRange outEdges(VertexDescriptor v, const FilteredGraph &fg) {
+		return OutEdgeRange(outEdges(v, *fg.g), fg.edgeFilter());
+	}
+
+	friend std::size_t outDegree(VertexDescriptor v, const FilteredGraph &fg) {
+		auto oe = outEdges(v, fg);
+		return std::distance(oe.begin(), oe.end());
+	}
+public: // BidirectionalGraph
+	friend InEdgeRange inEdges(VertexDescriptor v, const FilteredGraph &fg)
+	requires bidirectional {
+		return InEdgeRange(inEdges(v, *fg.g), fg.edgeFilter());
+	}
+
+	friend std::size_t inDegree(VertexDescriptor v, const FilteredGraph &fg)
+	requires bidirectional {
+		auto ie = inEdges(v, fg);
+		return std::distance(ie.begin(), ie.end());
+	}
+public: // Other
+	friend std::size_t getIndex(VertexDescriptor v, const FilteredGraph &fg) {
+		return getIndex(v, *fg.g);
+	}
+public: // PropertyGraph, read-only
+	decltype(auto) operator[](VertexDescriptor v) const requires (!std::is_void_v<VertexProp>) {
+		return (*g)[v];
+	}
+
+	decltype(auto) operator[](EdgeDescriptor e) const requires (!std::is_void_v<EdgeProp>) {
+		return (*g)[e];
+	}
+};
+
+/**
+ * @brief Creates a FilteredGraph view of `g`.
+ * @param g the underlying graph, which must outlive the view
+ * @param edgePred edges for which `edgePred(e)` is false are hidden
+ * @param vertexPred vertices for which `vertexPred(v)` is false are hidden, with their incident edges
+ */
+template<typename Graph, typename EdgePred, typename VertexPred = KeepAll>
+FilteredGraph<Graph, EdgePred, VertexPred>
+filteredGraph(const Graph &g, EdgePred edgePred, VertexPred vertexPred = KeepAll{}) {
+	return FilteredGraph<Graph, EdgePred, VertexPred>(g, edgePred, vertexPred);
+}
+
+} // namespace graph
+
+#endif // GRAPH_FILTERED_GRAPH_HPP
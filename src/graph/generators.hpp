@@ -0,0 +1,241 @@
+#ifndef GRAPH_GENERATORS_HPP
+#define GRAPH_GENERATORS_HPP
+
+#include "parallel.hpp"
+#include "simplify.hpp"
+
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Output of the generators: the number of vertices and the (src, tar) pairs of the edges.
+ * 			The edges can be passed to addEdges() of AdjacencyList, AdjacencyMatrix and TiledMatrix,
+ * 			to the edge list constructor of CompressedGraph or to writeBinaryAdjacency(),
+ * 			or turned into any mutable graph by makeGraph().
+ */
+struct GeneratedEdges {
+	std::size_t n = 0;
+	std::vector<std::pair<std::size_t, std::size_t>> edges;
+};
+
+namespace detail {
+
+// The splitmix64 finaliser, a bijection with good avalanche.
+inline std::uint64_t mix64(std::uint64_t x) {
+	x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+	return x ^ (x >> 31);
+}
+
+/**
+ * @brief Counter-based random numbers: the draw for (seed, stream, counter) is a pure function of
+ * 			its inputs, so edge i can be generated by any thread and the output does not depend on
+ * 			the number of threads. Generators use the edge index as counter and a stream per draw.
+ */
+inline std::uint64_t randomBits(std::uint64_t seed, std::uint64_t stream, std::uint64_t counter) {
+	return mix64(mix64(seed ^ mix64(stream + 0x9e3779b97f4a7c15ULL)) + counter);
+}
+
+// Maps random bits to [0, bound) by a multiply-high, without a division.
+inline std::size_t randomBelow(std::uint64_t bits, std::size_t bound) {
+	return static_cast<std::size_t>((static_cast<unsigned __int128>(bits) * bound) >> 64);
+}
+
+// Maps random bits to [0, 1).
+inline double randomUnit(std::uint64_t bits) {
+	return static_cast<double>(bits >> 11) * 0x1.0p-53;
+}
+
+/**
+ * @brief Emits the out edges of every vertex in vertex order: `degree(v)` is the number of out edges of v
+ * 			and `emit(v, out)` writes them starting at `out`. The offsets are a serial prefix sum,
+ * 			the edges are written in parallel.
+ */
+template<typename DegreeFn, typename EmitFn>
+GeneratedEdges generateByVertex(std::size_t n, DegreeFn degree, EmitFn emit) {
+	std::vector<std::size_t> offsets(n + 1, 0);
+	parallelFor(n, [&](std::size_t v) { offsets[v + 1] = degree(v); });
+	std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+	GeneratedEdges out;
+	out.n = n;
+	out.edges.resize(offsets.back());
+	parallelFor(n, [&](std::size_t v) { emit(v, out.edges.data() + offsets[v]); });
+	return out;
+}
+
+} // namespace detail
+
+/**
+ * @brief R-MAT (recursive matrix) generator as used by Graph500: every edge descends `scale` levels
+ * 			of the adjacency matrix, choosing the quadrant with probabilities a, b, c and 1 - a - b - c.
+ * 			Parallel edges and self-loops are kept, use simplify() or SimplifyOptions to drop them.
+ *
+ * @param scale the graph has 2^scale vertices
+ * @param edgeFactor the graph has edgeFactor * 2^scale edges
+ * @param seed seed of the counter-based random numbers
+ */
+inline GeneratedEdges rmat(std::size_t scale, std::size_t edgeFactor, std::uint64_t seed,
+                           double a = 0.57, double b = 0.19, double c = 0.19) {
+	GeneratedEdges out;
+	out.n = std::size_t(1) << scale;
+	out.edges.resize(edgeFactor * out.n);
+	detail::parallelFor(out.edges.size(), [&](std::size_t i) {
+		std::size_t src = 0, tar = 0;
+		for(std::size_t level = 0; level < scale; ++level) {
+			const double r = detail::randomUnit(detail::randomBits(seed, level, i));
+			const std::size_t bit = std::size_t(1) << (scale - 1 - level);
+			if(r >= a + b) src |= bit;
+			if((r >= a && r < a + b) || r >= a + b + c) tar |= bit;
+		}
+		out.edges[i] = {src, tar};
+	});
+	return out;
+}
+
+/**
+ * @brief Erdős–Rényi G(n, m): m distinct edges chosen uniformly among all n * (n - 1) pairs without
+ * 			self-loops. Candidates are drawn in parallel and deduplicated; missing edges are drawn from
+ * 			further counters until there are m. The edges come sorted by source, then target.
+ * 			Throws std::invalid_argument if m > n * (n - 1).
+ */
+inline GeneratedEdges erdosRenyi(std::size_t n, std::size_t m, std::uint64_t seed) {
+	if(n < 2 ? m > 0 : m > n * (n - 1))
+		throw std::invalid_argument("erdosRenyi: more edges than vertex pairs");
+	GeneratedEdges out;
+	out.n = n;
+	std::size_t next = 0; // first unused counter
+	while(out.edges.size() < m) {
+		const std::size_t missing = m - out.edges.size();
+		const std::size_t first = out.edges.size();
+		out.edges.resize(m);
+		detail::parallelFor(missing, [&](std::size_t i) {
+			const std::size_t src = detail::randomBelow(detail::randomBits(seed, 0, next + i), n);
+			// a target among the n - 1 other vertices, so there are no self-loops
+			std::size_t tar = detail::randomBelow(detail::randomBits(seed, 1, next + i), n - 1);
+			out.edges[first + i] = {src, tar + (tar >= src)};
+		});
+		next += missing;
+		out.edges = detail::simplifyPairs(out.edges, n, SimplifyOptions{true, true});
+	}
+	return out;
+}
+
+/**
+ * @brief Barabási–Albert preferential attachment by the copy model: vertex v >= 1 adds `d` edges to
+ * 			earlier vertices, each either to a uniform earlier vertex or, with probability 1/2, to the
+ * 			target of a uniform earlier edge, which picks vertices in proportion to their in-degree.
+ * 			A copied edge is resolved by following copies back to a uniform choice, so every edge is
+ * 			computed independently and in parallel. Edges point from the newer to the older vertex.
+ *
+ * @param n number of vertices
+ * @param d edges added by every vertex but the first
+ */
+inline GeneratedEdges barabasiAlbert(std::size_t n, std::size_t d, std::uint64_t seed) {
+	GeneratedEdges out;
+	out.n = n;
+	if(n < 2) return out;
+	out.edges.resize((n - 1) * d);
+	detail::parallelFor(out.edges.size(), [&](std::size_t i) {
+		const std::size_t src = i / d + 1;
+		std::size_t k = i;
+		for(;;) {
+			const std::size_t kSrc = k / d + 1;
+			const std::size_t earlierEdges = (kSrc - 1) * d;
+			const std::uint64_t bits = detail::randomBits(seed, 0, k);
+			if(earlierEdges == 0 || (bits & 1)) {
+				out.edges[i] = {src, detail::randomBelow(detail::randomBits(seed, 1, k), kSrc)};
+				return;
+			}
+			k = detail::randomBelow(detail::randomBits(seed, 2, k), earlierEdges);
+		}
+	});
+	return out;
+}
+
+/**
+ * @brief rows x cols grid, every vertex r * cols + c connected in both directions to its
+ * 			horizontal and vertical neighbours. With `periodic` the grid wraps around into a torus.
+ */
+inline GeneratedEdges grid2d(std::size_t rows, std::size_t cols, bool periodic = false) {
+	const std::size_t dims[2] = {rows, cols};
+	auto neighbours = [&](std::size_t v, auto emit) {
+		const std::size_t pos[2] = {v / cols, v % cols};
+		const std::size_t stride[2] = {cols, 1};
+		for(std::size_t d = 0; d < 2; ++d) {
+			if(dims[d] < 2) continue;
+			if(pos[d] > 0) emit(v - stride[d]);
+			else if(periodic && dims[d] > 2) emit(v + (dims[d] - 1) * stride[d]);
+			if(pos[d] + 1 < dims[d]) emit(v + stride[d]);
+			else if(periodic && dims[d] > 2) emit(v - (dims[d] - 1) * stride[d]);
+		}
+	};
+	return detail::generateByVertex(rows * cols,
+		[&](std::size_t v) { std::size_t k = 0; neighbours(v, [&](std::size_t) { ++k; }); return k; },
+		[&](std::size_t v, auto *out) { neighbours(v, [&](std::size_t u) { *out++ = {v, u}; }); });
+}
+
+/**
+ * @brief x * y * z grid, every vertex (i * y + j) * z + k connected in both directions to its
+ * 			neighbours along each axis. With `periodic` every axis wraps around.
+ */
+inline GeneratedEdges grid3d(std::size_t x, std::size_t y, std::size_t z, bool periodic = false) {
+	const std::size_t dims[3] = {x, y, z};
+	auto neighbours = [&](std::size_t v, auto emit) {
+		const std::size_t pos[3] = {v / (y * z), v / z % y, v % z};
+		const std::size_t stride[3] = {y * z, z, 1};
+		for(std::size_t d = 0; d < 3; ++d) {
+			if(dims[d] < 2) continue;
+			if(pos[d] > 0) emit(v - stride[d]);
+			else if(periodic && dims[d] > 2) emit(v + (dims[d] - 1) * stride[d]);
+			if(pos[d] + 1 < dims[d]) emit(v + stride[d]);
+			else if(periodic && dims[d] > 2) emit(v - (dims[d] - 1) * stride[d]);
+		}
+	};
+	return detail::generateByVertex(x * y * z,
+		[&](std::size_t v) { std::size_t k = 0; neighbours(v, [&](std::size_t) { ++k; }); return k; },
+		[&](std::size_t v, auto *out) { neighbours(v, [&](std::size_t u) { *out++ = {v, u}; }); });
+}
+
+/**
+ * @brief Random DAG with m edges (u, v), u < v, chosen uniformly with replacement, so vertex order is
+ * 			a topological order. Parallel edges may occur.
+ * 			Throws std::invalid_argument if m > 0 and there are fewer than two vertices.
+ */
+inline GeneratedEdges randomDag(std::size_t n, std::size_t m, std::uint64_t seed) {
+	if(n < 2 && m > 0)
+		throw std::invalid_argument("randomDag: edges need at least two vertices");
+	GeneratedEdges out;
+	out.n = n;
+	out.edges.resize(m);
+	detail::parallelFor(m, [&](std::size_t i) {
+		const std::size_t u = detail::randomBelow(detail::randomBits(seed, 0, i), n);
+		const std::size_t v = detail::randomBelow(detail::randomBits(seed, 1, i), n - 1);
+		const std::size_t w = v + (v >= u); // a vertex other than u
+		out.edges[i] = {std::min(u, w), std::max(u, w)};
+	});
+	return out;
+}
+
+/**
+ * @brief Builds a `Graph` with the generated vertices and edges, using the bulk addEdges() when
+ * 			the graph provides it.
+ */
+template<typename Graph>
+Graph makeGraph(const GeneratedEdges &gen) {
+	Graph g(gen.n);
+	if constexpr(requires { addEdges(gen.edges, g); }) {
+		addEdges(gen.edges, g);
+	} else {
+		for(auto [src, tar] : gen.edges) addEdge(src, tar, g);
+	}
+	return g;
+}
+
+} // namespace graph
+
+#endif // GRAPH_GENERATORS_HPP
@@ -0,0 +1,31 @@
+#ifndef GRAPH_INSTRUMENTATION_HPP
+#define GRAPH_INSTRUMENTATION_HPP
+
+// Instrumentation points of the algorithms. GRAPH_PHASE(name) marks the rest of the enclosing scope
+// as the phase `name`, a string literal. Defined before the library headers are included,
+// GRAPH_ENABLE_PERF_COUNTERS collects the wall time and hardware counters of every phase, see
+// perf_counters.hpp and printPhaseReport(), and GRAPH_ENABLE_TRACING records the begin and end of
+// every phase run for a timeline, see trace.hpp and writeChromeTrace(). Both can be enabled at once.
+// Otherwise GRAPH_PHASE expands to nothing and costs nothing.
+
+#define GRAPH_PHASE_CONCAT_(a, b) a##b
+#define GRAPH_PHASE_CONCAT(a, b) GRAPH_PHASE_CONCAT_(a, b)
+
+#ifdef GRAPH_ENABLE_TRACING
+#include "trace.hpp"
+#define GRAPH_PHASE_TRACE_(name) ::graph::ScopedTrace GRAPH_PHASE_CONCAT(graphTrace_, __LINE__)(name);
+#else
+#define GRAPH_PHASE_TRACE_(name)
+#endif
+
+#ifdef GRAPH_ENABLE_PERF_COUNTERS
+#include "perf_counters.hpp"
+#define GRAPH_PHASE_COUNTERS_(name) ::graph::ScopedPhase GRAPH_PHASE_CONCAT(graphPhase_, __LINE__)(name);
+#else
+#define GRAPH_PHASE_COUNTERS_(name)
+#endif
+
+// the trace span encloses the counter readings, so both report the same nesting
+#define GRAPH_PHASE(name) GRAPH_PHASE_TRACE_(name) GRAPH_PHASE_COUNTERS_(name) ((void)0)
+
+#endif // GRAPH_INSTRUMENTATION_HPP
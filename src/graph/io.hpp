@@ -1,9 +1,13 @@
 #ifndef GRAPH_IO_HPP
 #define GRAPH_IO_HPP
 
+#include "instrumentation.hpp"
+#include "simplify.hpp"
 #include "traits.hpp"
 
 #include <iostream>
+#include <optional>
+#include <vector>
 
 namespace graph {
 
@@ -18,8 +22,13 @@ namespace graph {
 // - The following ``<m>`` lines have the form ``e <src> <tar>``, where
 //   ``<src>`` and ``<tar>`` are positive integers from 1 through ``<n>``,
 //   denoting respectively the source and target of an edge.
+//
+// If `simplifyOpts` is given, all edges are read first and parallel edges and/or
+// self-loops are dropped (see simplify()) before the graph is built, using
+// `addEdges` for bulk construction when the graph provides it.
 template<typename Graph>
-Graph loadDimacs(std::istream &s) {
+Graph loadDimacs(std::istream &s, std::optional<SimplifyOptions> simplifyOpts = std::nullopt) {
+	GRAPH_PHASE("loadDimacs");
 	auto error = [](auto &&msg) {
 		throw std::runtime_error(std::string("Parsing error: ") + msg);
 	};
@@ -33,16 +42,31 @@ Graph loadDimacs(std::istream &s) {
 	if(!(s >> m)) error("Expected number of edges.");
 
 	Graph g(n);
-	using Vertex = typename graph::Traits<Graph>::VertexDescriptor;
-	using Edge = typename graph::Traits<Graph>::EdgeDescriptor;
+	std::vector<std::pair<std::size_t, std::size_t>> pairs;
+	if(simplifyOpts) pairs.reserve(m);
 
-	for(std::size_t i = 1; i <= m; ++i) {
-		if(!(s >> cmd) || cmd != 'e') error("Expected 'e' for edge " + std::to_string(i) + ".");
-		std::size_t src, tar;
-		if(!(s >> src >> tar)) error("Expected source and target for edge " + std::to_string(i) + ".");
-		if(src == 0 || src > n) error("Source " + std::to_string(src) + " for edge " + std::to_string(i) + " is out of bounds.");
-		if(tar == 0 || tar > n) error("Target " + std::to_string(tar) + " for edge " + std::to_string(i) + " is out of bounds.");
-		addEdge(src - 1, tar - 1, g);
+	{
+		GRAPH_PHASE("loadDimacs/parse");
+		for(std::size_t i = 1; i <= m; ++i) {
+			if(!(s >> cmd) || cmd != 'e') error("Expected 'e' for edge " + std::to_string(i) + ".");
+			std::size_t src, tar;
+			if(!(s >> src >> tar)) error("Expected source and target for edge " + std::to_string(i) + ".");
+			if(src == 0 || src > n) error("Source " + std::to_string(src) + " for edge " + std::to_string(i) + " is out of bounds.");
+			if(tar == 0 || tar > n) error("Target " + std::to_string(tar) + " for edge " + std::to_string(i) + " is out of bounds.");
+			if(simplifyOpts) pairs.emplace_back(src - 1, tar - 1);
+			else addEdge(src - 1, tar - 1, g);
+		}
+	}
+	if(simplifyOpts) {
+		{
+			GRAPH_PHASE("loadDimacs/simplify");
+			pairs = detail::simplifyPairs(pairs, n, *simplifyOpts);
+		}
+		if constexpr(requires { addEdges(pairs, g); }) {
+			addEdges(pairs, g);
+		} else {
+			for(auto [src, tar] : pairs) addEdge(src, tar, g);
+		}
 	}
 	return g;
 }
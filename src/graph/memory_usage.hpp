@@ -0,0 +1,50 @@
+#ifndef GRAPH_MEMORY_USAGE_HPP
+#define GRAPH_MEMORY_USAGE_HPP
+
+#include <cstddef>
+
+namespace graph {
+
+/**
+ * @brief Breakdown of the heap memory of a graph in bytes, as returned by memoryUsage(g).
+ * 			Every byte is counted once: the `...Size` fields and `properties` are in use,
+ * 			`slack` is reserved by containers but unused and can be released with shrinkToFit(g).
+ */
+struct MemoryUsage {
+	// per-vertex records, e.g. the vertex list of an AdjacencyList without the vertex properties
+	std::size_t vertexArray = 0;
+	// per-edge topology records, e.g. the edge list of an AdjacencyList or the cells of a matrix
+	std::size_t edgeArray = 0;
+	// per-vertex adjacency entries stored outside the vertex array
+	std::size_t adjacencySize = 0;
+	// bytes reserved for the adjacency entries outside the vertex array, adjacencySize plus its slack
+	std::size_t adjacencyCapacity = 0;
+	// vertex and edge properties
+	std::size_t properties = 0;
+	// reserved but unused capacity of all containers
+	std::size_t slack = 0;
+public:
+	std::size_t total() const {
+		return vertexArray + edgeArray + adjacencySize + properties + slack;
+	}
+};
+
+namespace detail {
+
+// Bytes used by the elements of the vector-like container `c`.
+template<typename Container>
+std::size_t usedBytes(const Container &c) {
+	return c.size() * sizeof(typename Container::value_type);
+}
+
+// Bytes reserved but not used by the vector-like container `c`.
+template<typename Container>
+std::size_t slackBytes(const Container &c) {
+	return (c.capacity() - c.size()) * sizeof(typename Container::value_type);
+}
+
+} // namespace detail
+
+} // namespace graph
+
+#endif // GRAPH_MEMORY_USAGE_HPP
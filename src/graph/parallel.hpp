@@ -0,0 +1,154 @@
+#ifndef GRAPH_PARALLEL_HPP
+#define GRAPH_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <thread>
+#include <vector>
+
+#ifdef GRAPH_ENABLE_PERF_COUNTERS
+#include "perf_counters.hpp"
+#endif
+
+namespace graph {
+namespace detail {
+
+inline std::atomic<std::size_t> &threadCountSetting() {
+	static std::atomic<std::size_t> n{0};
+	return n;
+}
+
+// Inputs smaller than this are not worth spawning a thread for.
+inline constexpr std::size_t minChunkSize = 4096;
+
+} // namespace detail
+
+/**
+ * @brief Sets the number of threads used by the parallel algorithms of the library.
+ * @param n number of threads, 0 means std::thread::hardware_concurrency().
+ */
+inline void setNumThreads(std::size_t n) {
+	detail::threadCountSetting() = n;
+}
+
+/**
+ * @return the number of threads used by the parallel algorithms of the library.
+ */
+inline std::size_t numThreads() {
+	std::size_t n = detail::threadCountSetting();
+	if(n == 0) n = std::thread::hardware_concurrency();
+	return std::max<std::size_t>(n, 1);
+}
+
+namespace detail {
+
+/**
+ * @return the number of chunks parallelChunks splits `n` work items into.
+ */
+inline std::size_t numChunks(std::size_t n) {
+	return std::clamp<std::size_t>(n / minChunkSize, 1, numThreads());
+}
+
+/**
+ * @brief Splits [0, n) into numChunks(n) contiguous chunks and calls `f(chunk, begin, end)`
+ * 			for each of them, every chunk but the first on its own thread.
+ * 			Chunk boundaries only depend on `n` and numThreads().
+ */
+template<typename F>
+void parallelChunks(std::size_t n, F &&f) {
+	const std::size_t chunks = numChunks(n);
+	auto begin = [&](std::size_t c) { return n * c / chunks; };
+#ifdef GRAPH_ENABLE_PERF_COUNTERS
+	// the counters of a phase only follow the thread it runs on, the workers add their own counts
+	ScopedPhase *const phase = ScopedPhase::current();
+	auto work = [&, phase](std::size_t c) {
+		PhaseWorker counted(phase);
+		f(c, begin(c), begin(c + 1));
+	};
+#else
+	auto work = [&](std::size_t c) { f(c, begin(c), begin(c + 1)); };
+#endif
+	std::vector<std::thread> threads;
+	threads.reserve(chunks - 1);
+	for(std::size_t c = 1; c < chunks; ++c) threads.emplace_back(work, c);
+	f(0, begin(0), begin(1));
+	for(auto &t : threads) t.join();
+}
+
+/**
+ * @brief Calls `f(i)` for every i in [0, n), in parallel.
+ */
+template<typename F>
+void parallelFor(std::size_t n, F &&f) {
+	parallelChunks(n, [&](std::size_t, std::size_t first, std::size_t last) {
+		for(std::size_t i = first; i != last; ++i) f(i);
+	});
+}
+
+// Most buckets a single counting sort pass uses, larger key ranges are sorted a digit at a time.
+inline constexpr unsigned maxRadixBits = 16;
+
+/**
+ * @brief One stable parallel counting sort pass. Every chunk counts the digits of its elements
+ * 			into a private histogram, the histograms are prefix summed digit-major, and every
+ * 			chunk scatters its own elements.
+ * @param digit function returning the digit in [0, buckets) of an element
+ */
+template<typename T, typename DigitFn>
+void countingSortPass(const std::vector<T> &in, std::vector<T> &out, std::size_t buckets, DigitFn digit) {
+	const std::size_t chunks = numChunks(in.size());
+	std::vector<std::vector<std::size_t>> offsets(chunks);
+	parallelChunks(in.size(), [&](std::size_t c, std::size_t first, std::size_t last) {
+		offsets[c].assign(buckets, 0);
+		for(std::size_t i = first; i != last; ++i) ++offsets[c][digit(in[i])];
+	});
+	std::size_t sum = 0;
+	for(std::size_t d = 0; d < buckets; ++d) {
+		for(std::size_t c = 0; c < chunks; ++c) {
+			const std::size_t count = offsets[c][d];
+			offsets[c][d] = sum;
+			sum += count;
+		}
+	}
+	parallelChunks(in.size(), [&](std::size_t c, std::size_t first, std::size_t last) {
+		for(std::size_t i = first; i != last; ++i) out[offsets[c][digit(in[i])]++] = in[i];
+	});
+}
+
+/**
+ * @brief Stable parallel LSD radix sort. The keys are split into equally wide digits of at most
+ * 			maxRadixBits bits, and every digit is sorted with countingSortPass(), so the scratch
+ * 			histograms take O(numThreads() * 2^maxRadixBits) memory whatever `numKeys` is.
+ * @param in elements to sort
+ * @param numKeys upper bound on the keys
+ * @param key function returning the key in [0, numKeys) of an element
+ * @return `in` stably sorted by key.
+ */
+template<typename T, typename KeyFn>
+std::vector<T> countingSort(const std::vector<T> &in, std::size_t numKeys, KeyFn key) {
+	const unsigned bits = numKeys > 1 ? std::bit_width(numKeys - 1) : 0;
+	if(bits == 0) return in;
+	const unsigned passes = (bits + maxRadixBits - 1) / maxRadixBits;
+	const unsigned digitBits = (bits + passes - 1) / passes;
+	const std::size_t mask = (std::size_t(1) << digitBits) - 1;
+
+	std::vector<T> out(in.size());
+	if(passes == 1) {
+		countingSortPass(in, out, mask + 1, key);
+		return out;
+	}
+	std::vector<T> cur = in;
+	for(unsigned shift = 0; shift < bits; shift += digitBits) {
+		countingSortPass(cur, out, mask + 1, [&](const T &x) {
+			return (static_cast<std::size_t>(key(x)) >> shift) & mask;
+		});
+		cur.swap(out);
+	}
+	return cur;
+}
+
+} // namespace detail
+} // namespace graph
+
+#endif // GRAPH_PARALLEL_HPP
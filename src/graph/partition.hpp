@@ -0,0 +1,422 @@
+#ifndef GRAPH_PARTITION_HPP
+#define GRAPH_PARTITION_HPP
+
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "properties.hpp"
+#include "property_map.hpp"
+#include "simplify.hpp"
+#include "traits.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <numeric>
+#include <queue>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Tuning knobs of partition().
+ */
+struct PartitionOptions {
+	// allowed relative overweight of a part, i.e. parts may hold (1 + imbalance) * n / k vertices
+	double imbalance = 0.03;
+	// stop coarsening once the graph has at most this many vertices, 0 means max(20 * k, 128)
+	std::size_t coarsenTo = 0;
+	// maximum number of refinement sweeps per level
+	std::size_t refinementPasses = 8;
+	// seed for the visiting order of the matching
+	std::uint64_t seed = 1;
+};
+
+namespace detail {
+
+/**
+ * @brief Symmetric weighted CSR used on every level of the multilevel partitioner.
+ * 			Parallel edges are merged by summing their weights and self-loops are dropped.
+ */
+struct WeightedCSR {
+	std::size_t size() const { return vertexWeights.size(); }
+
+	std::vector<std::size_t> offsets;
+	std::vector<std::size_t> targets;
+	std::vector<std::int64_t> weights;
+	std::vector<std::int64_t> vertexWeights;
+};
+
+template<typename Graph, typename WeightFn>
+WeightedCSR makeWeightedCSR(const Graph &g, WeightFn edgeWeight) {
+	struct Arc { std::size_t src, tar; std::int64_t w; };
+	std::vector<Arc> arcs;
+	arcs.reserve(2 * numEdges(g));
+	for(auto e : edges(g)) {
+		const auto s = getIndex(source(e, g), g), t = getIndex(target(e, g), g);
+		if(s == t) continue;
+		const auto w = static_cast<std::int64_t>(edgeWeight(e));
+		arcs.push_back({s, t, w});
+		arcs.push_back({t, s, w});
+	}
+	std::vector<std::size_t> positions(arcs.size());
+	std::iota(positions.begin(), positions.end(), 0);
+	positions = sortBySourceTarget(positions, numVertices(g),
+		[&](std::size_t i) { return arcs[i].src; },
+		[&](std::size_t i) { return arcs[i].tar; });
+
+	WeightedCSR csr;
+	csr.vertexWeights.assign(numVertices(g), 1);
+	csr.offsets.assign(numVertices(g) + 1, 0);
+	for(std::size_t k = 0; k < positions.size(); ++k) {
+		const Arc &a = arcs[positions[k]];
+		if(k > 0 && arcs[positions[k - 1]].src == a.src && arcs[positions[k - 1]].tar == a.tar) {
+			csr.weights.back() += a.w;
+			continue;
+		}
+		csr.targets.push_back(a.tar);
+		csr.weights.push_back(a.w);
+		++csr.offsets[a.src + 1];
+	}
+	std::partial_sum(csr.offsets.begin(), csr.offsets.end(), csr.offsets.begin());
+	return csr;
+}
+
+/**
+ * @brief Parallel heavy-edge matching by handshakes: in every round each unmatched vertex points to
+ * 			the unmatched neighbour sharing its heaviest edge, as long as the merged weight stays below
+ * 			`maxWeight`, and two vertices pointing to each other are matched. Ties are broken by random
+ * 			edge keys that both endpoints agree on, so the heaviest remaining edge is always mutual and
+ * 			every round makes progress. Stops after `maxRounds` rounds or when no pair is found.
+ * @param coarseOf set to the coarse vertex of every vertex
+ * @return the number of coarse vertices.
+ */
+inline std::size_t heavyEdgeMatching(const WeightedCSR &g, std::int64_t maxWeight, std::mt19937_64 &rng,
+                                     std::vector<std::size_t> &coarseOf, std::size_t maxRounds = 8) {
+	constexpr std::size_t unmatched = std::numeric_limits<std::size_t>::max();
+	const std::size_t n = g.size();
+	std::vector<std::uint64_t> rank(n);
+	for(auto &r : rank) r = rng();
+	std::vector<std::size_t> mate(n, unmatched), pref(n);
+	std::vector<char> progress(numChunks(n));
+	for(std::size_t round = 0; round < maxRounds; ++round) {
+		parallelFor(n, [&](std::size_t u) {
+			pref[u] = unmatched;
+			if(mate[u] != unmatched) return;
+			std::int64_t bestWeight = std::numeric_limits<std::int64_t>::min();
+			std::uint64_t bestKey = 0;
+			for(std::size_t i = g.offsets[u]; i < g.offsets[u + 1]; ++i) {
+				const std::size_t v = g.targets[i];
+				if(mate[v] != unmatched || g.vertexWeights[u] + g.vertexWeights[v] > maxWeight) continue;
+				// the same key from both endpoints, distinct among the edges of u
+				const std::uint64_t key = rank[u] ^ rank[v];
+				if(pref[u] == unmatched || g.weights[i] > bestWeight || (g.weights[i] == bestWeight && key > bestKey)) {
+					bestWeight = g.weights[i];
+					bestKey = key;
+					pref[u] = v;
+				}
+			}
+		});
+		std::fill(progress.begin(), progress.end(), false);
+		parallelChunks(n, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+			for(std::size_t u = first; u != last; ++u) {
+				if(pref[u] != unmatched && pref[pref[u]] == u) {
+					mate[u] = pref[u];
+					progress[chunk] = true;
+				}
+			}
+		});
+		if(std::find(progress.begin(), progress.end(), true) == progress.end()) break;
+	}
+	coarseOf.assign(n, unmatched);
+	std::size_t nc = 0;
+	for(std::size_t u = 0; u < n; ++u) {
+		if(coarseOf[u] != unmatched) continue;
+		coarseOf[u] = nc;
+		if(mate[u] != unmatched) coarseOf[mate[u]] = nc;
+		++nc;
+	}
+	return nc;
+}
+
+/**
+ * @brief Contracts the matched vertices of `g`. Coarse vertices are split into contiguous chunks
+ * 			which are built in parallel into private buffers and then concatenated.
+ */
+inline WeightedCSR contract(const WeightedCSR &g, const std::vector<std::size_t> &coarseOf, std::size_t nc) {
+	// members[c] are the (one or two) fine vertices of coarse vertex c
+	std::vector<std::size_t> memberOffsets(nc + 1, 0), members(g.size());
+	for(auto c : coarseOf) ++memberOffsets[c + 1];
+	std::partial_sum(memberOffsets.begin(), memberOffsets.end(), memberOffsets.begin());
+	{
+		std::vector<std::size_t> fill(memberOffsets.begin(), memberOffsets.end() - 1);
+		for(std::size_t u = 0; u < g.size(); ++u) members[fill[coarseOf[u]]++] = u;
+	}
+
+	struct Buffer {
+		std::vector<std::size_t> degrees, targets;
+		std::vector<std::int64_t> weights;
+	};
+	std::vector<Buffer> buffers(numChunks(nc));
+	WeightedCSR res;
+	res.vertexWeights.resize(nc);
+	parallelChunks(nc, [&](std::size_t chunk, std::size_t first, std::size_t last) {
+		Buffer &buf = buffers[chunk];
+		std::vector<std::int64_t> acc(nc, 0);
+		// a separate marker, weights may cancel out or be zero
+		std::vector<char> isTouched(nc, false);
+		std::vector<std::size_t> touched;
+		for(std::size_t c = first; c != last; ++c) {
+			res.vertexWeights[c] = 0;
+			for(std::size_t m = memberOffsets[c]; m < memberOffsets[c + 1]; ++m) {
+				const std::size_t u = members[m];
+				res.vertexWeights[c] += g.vertexWeights[u];
+				for(std::size_t i = g.offsets[u]; i < g.offsets[u + 1]; ++i) {
+					const std::size_t d = coarseOf[g.targets[i]];
+					if(d == c) continue;
+					if(!isTouched[d]) {
+						isTouched[d] = true;
+						touched.push_back(d);
+					}
+					acc[d] += g.weights[i];
+				}
+			}
+			buf.degrees.push_back(touched.size());
+			for(auto d : touched) {
+				buf.targets.push_back(d);
+				buf.weights.push_back(acc[d]);
+				acc[d] = 0;
+				isTouched[d] = false;
+			}
+			touched.clear();
+		}
+	});
+
+	res.offsets.assign(nc + 1, 0);
+	std::size_t c = 0;
+	for(auto &buf : buffers) {
+		for(auto d : buf.degrees) {
+			res.offsets[c + 1] = res.offsets[c] + d;
+			++c;
+		}
+		res.targets.insert(res.targets.end(), buf.targets.begin(), buf.targets.end());
+		res.weights.insert(res.weights.end(), buf.weights.begin(), buf.weights.end());
+	}
+	return res;
+}
+
+/**
+ * @brief Greedy graph growing on the coarsest graph: parts 0 to k - 2 are grown one at a time
+ * 			from the heaviest unassigned vertex, always adding the unassigned vertex with the
+ * 			strongest connection to the part, until the part reaches its share of the weight.
+ * 			The remaining vertices form part k - 1.
+ */
+inline std::vector<std::size_t> growInitialPartition(const WeightedCSR &g, std::size_t k) {
+	const std::int64_t total = std::accumulate(g.vertexWeights.begin(), g.vertexWeights.end(), std::int64_t(0));
+	std::vector<std::size_t> part(g.size(), k - 1);
+	std::vector<char> assigned(g.size(), false);
+	std::vector<std::int64_t> conn(g.size(), 0);
+	std::int64_t assignedWeight = 0;
+	for(std::size_t p = 0; p + 1 < k; ++p) {
+		const std::int64_t target = (total - assignedWeight) / static_cast<std::int64_t>(k - p);
+		std::int64_t weight = 0;
+		std::fill(conn.begin(), conn.end(), 0);
+		std::priority_queue<std::pair<std::int64_t, std::size_t>> heap;
+		while(weight < target) {
+			std::size_t v = g.size();
+			while(!heap.empty()) {
+				auto [c, u] = heap.top();
+				heap.pop();
+				if(!assigned[u] && c == conn[u]) {
+					v = u;
+					break;
+				}
+			}
+			if(v == g.size()) {
+				// start a new region, e.g. for disconnected graphs
+				for(std::size_t u = 0; u < g.size(); ++u)
+					if(!assigned[u] && (v == g.size() || g.vertexWeights[u] > g.vertexWeights[v])) v = u;
+				if(v == g.size()) break;
+			}
+			assigned[v] = true;
+			part[v] = p;
+			weight += g.vertexWeights[v];
+			for(std::size_t i = g.offsets[v]; i < g.offsets[v + 1]; ++i) {
+				const std::size_t u = g.targets[i];
+				if(assigned[u]) continue;
+				conn[u] += g.weights[i];
+				heap.emplace(conn[u], u);
+			}
+		}
+		assignedWeight += weight;
+	}
+	return part;
+}
+
+/**
+ * @brief Greedy boundary refinement in the spirit of label propagation and FM: every vertex moves
+ * 			to the neighbouring part it is most strongly connected to if that reduces the cut and
+ * 			keeps the target part within `maxPartWeight`. Vertices of overweight parts may also make
+ * 			cut-increasing moves into parts with room, which restores balance. `part` holds the part of
+ * 			every vertex of `g` and is updated in place.
+ */
+template<ReadWritePropertyMap<std::size_t> PartMap>
+void refine(const WeightedCSR &g, std::size_t k, std::int64_t maxPartWeight, std::size_t passes, PartMap &part) {
+	std::vector<std::int64_t> partWeight(k, 0);
+	for(std::size_t v = 0; v < g.size(); ++v) partWeight[get(part, v)] += g.vertexWeights[v];
+	std::vector<std::int64_t> conn(k, 0);
+	// a separate marker, weights may cancel out or be zero
+	std::vector<char> isTouched(k, false);
+	std::vector<std::size_t> touched;
+	for(std::size_t pass = 0; pass < passes; ++pass) {
+		std::size_t moves = 0;
+		for(std::size_t v = 0; v < g.size(); ++v) {
+			const std::size_t from = get(part, v);
+			const std::int64_t w = g.vertexWeights[v];
+			for(std::size_t i = g.offsets[v]; i < g.offsets[v + 1]; ++i) {
+				const std::size_t p = get(part, g.targets[i]);
+				if(!isTouched[p]) {
+					isTouched[p] = true;
+					touched.push_back(p);
+				}
+				conn[p] += g.weights[i];
+			}
+			const bool overweight = partWeight[from] > maxPartWeight;
+			std::size_t best = from;
+			std::int64_t bestGain = overweight ? std::numeric_limits<std::int64_t>::min() : 0;
+			auto consider = [&](std::size_t p) {
+				if(p == from || partWeight[p] + w > maxPartWeight) return;
+				const std::int64_t gain = conn[p] - conn[from];
+				if(gain > bestGain || (gain == bestGain && best != from && partWeight[p] < partWeight[best])) {
+					best = p;
+					bestGain = gain;
+				}
+			};
+			for(auto p : touched) consider(p);
+			// an overweight part may also shed a vertex into a non-adjacent part
+			if(overweight && best == from) {
+				for(std::size_t p = 0; p < k; ++p) consider(p);
+			}
+			for(auto p : touched) {
+				conn[p] = 0;
+				isTouched[p] = false;
+			}
+			conn[from] = 0;
+			touched.clear();
+			if(best == from) continue;
+			put(part, v, best);
+			partWeight[from] -= w;
+			partWeight[best] += w;
+			++moves;
+		}
+		if(moves == 0) break;
+	}
+}
+
+// The edge property if it is arithmetic, 1 otherwise.
+template<typename Graph>
+std::int64_t defaultEdgeWeight(const Graph &g, const typename Traits<Graph>::EdgeDescriptor &e) {
+	if constexpr(hasEdgeProp<Graph> && std::is_arithmetic_v<typename Traits<Graph>::EdgeProp>)
+		return static_cast<std::int64_t>(g[e]);
+	else
+		return 1;
+}
+
+} // namespace detail
+
+/**
+ * @brief Multilevel k-way partitioning minimising the total weight of cut edges, ignoring edge direction.
+ * 			The graph is coarsened by parallel heavy-edge matching, with the contraction of every level
+ * 			built in parallel, until it is small; the coarsest graph is partitioned by greedy graph growing;
+ * 			and the partition is projected back level by level and improved by greedy boundary
+ * 			refinement under the balance constraint of `opts.imbalance`. The finest level is projected
+ * 			into and refined in `part` itself.
+ * @param g graph to partition
+ * @param k number of parts
+ * @param edgeWeight callable returning the integral weight of an edge descriptor
+ * @param part property map with a key for every vertex index, is set to the part in [0, k) of every vertex
+ * @param opts tuning knobs
+ */
+template<typename Graph, typename WeightFn, ReadWritePropertyMap<std::size_t> PartMap>
+void partition(const Graph &g, std::size_t k, WeightFn edgeWeight, PartMap &part, PartitionOptions opts = {}) {
+	GRAPH_PHASE("partition");
+	if(k <= 1 || numVertices(g) == 0) {
+		for(std::size_t v = 0; v < numVertices(g); ++v) put(part, v, 0);
+		return;
+	}
+	const std::size_t coarsenTo = opts.coarsenTo ? opts.coarsenTo : std::max<std::size_t>(20 * k, 128);
+	std::mt19937_64 rng(opts.seed);
+
+	std::vector<detail::WeightedCSR> levels;
+	std::vector<std::vector<std::size_t>> coarseOf;
+	levels.push_back(detail::makeWeightedCSR(g, edgeWeight));
+	const std::int64_t total = static_cast<std::int64_t>(numVertices(g));
+	// keep coarse vertices light enough that a balanced partition stays possible
+	const std::int64_t maxVertexWeight = std::max<std::int64_t>(1, total / static_cast<std::int64_t>(coarsenTo));
+	while(levels.back().size() > coarsenTo) {
+		std::vector<std::size_t> map;
+		const std::size_t nc = detail::heavyEdgeMatching(levels.back(), maxVertexWeight, rng, map);
+		if(nc * 10 > levels.back().size() * 9) break;
+		levels.push_back(detail::contract(levels.back(), map, nc));
+		coarseOf.push_back(std::move(map));
+	}
+
+	const std::int64_t maxPartWeight = static_cast<std::int64_t>(
+		(1 + opts.imbalance) * static_cast<double>((total + static_cast<std::int64_t>(k) - 1) / static_cast<std::int64_t>(k)));
+	std::vector<std::size_t> coarse = detail::growInitialPartition(levels.back(), k);
+	if(coarseOf.empty()) {
+		// g is the coarsest level
+		for(std::size_t v = 0; v < coarse.size(); ++v) put(part, v, coarse[v]);
+		detail::refine(levels[0], k, maxPartWeight, opts.refinementPasses, part);
+		return;
+	}
+	detail::VectorRefMap<std::size_t> coarseMap{&coarse};
+	detail::refine(levels.back(), k, maxPartWeight, opts.refinementPasses, coarseMap);
+	for(std::size_t l = coarseOf.size(); l-- > 1;) {
+		std::vector<std::size_t> finer(levels[l].size());
+		for(std::size_t u = 0; u < finer.size(); ++u) finer[u] = coarse[coarseOf[l][u]];
+		coarse = std::move(finer);
+		detail::refine(levels[l], k, maxPartWeight, opts.refinementPasses, coarseMap);
+	}
+	for(std::size_t v = 0; v < levels[0].size(); ++v) put(part, v, coarse[coarseOf[0][v]]);
+	detail::refine(levels[0], k, maxPartWeight, opts.refinementPasses, part);
+}
+
+/**
+ * @brief See above, returning the part of every vertex, indexed by getIndex().
+ */
+template<typename Graph, typename WeightFn>
+std::vector<std::size_t> partition(const Graph &g, std::size_t k, WeightFn edgeWeight, PartitionOptions opts = {}) {
+	std::vector<std::size_t> part(numVertices(g));
+	detail::VectorRefMap<std::size_t> map{&part};
+	partition(g, k, edgeWeight, map, opts);
+	return part;
+}
+
+/**
+ * @brief See above, using the edge property as weight if it is arithmetic, and 1 otherwise.
+ */
+template<typename Graph>
+std::vector<std::size_t> partition(const Graph &g, std::size_t k, PartitionOptions opts = {}) {
+	return partition(g, k, [&g](const auto &e) {
+		return detail::defaultEdgeWeight(g, e);
+	}, opts);
+}
+
+/**
+ * @return the total weight of the edges whose endpoints are in different parts.
+ */
+template<typename Graph, typename WeightFn>
+std::int64_t edgeCut(const Graph &g, const std::vector<std::size_t> &part, WeightFn edgeWeight) {
+	std::int64_t cut = 0;
+	for(auto e : edges(g)) {
+		if(part[getIndex(source(e, g), g)] != part[getIndex(target(e, g), g)])
+			cut += static_cast<std::int64_t>(edgeWeight(e));
+	}
+	return cut;
+}
+
+} // namespace graph
+
+#endif // GRAPH_PARTITION_HPP
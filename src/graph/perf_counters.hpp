@@ -0,0 +1,307 @@
+#ifndef GRAPH_PERF_COUNTERS_HPP
+#define GRAPH_PERF_COUNTERS_HPP
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Hardware event counts, either totals or the difference between two readings.
+ */
+struct CounterValues {
+	std::uint64_t cycles = 0;
+	std::uint64_t instructions = 0;
+	std::uint64_t llcMisses = 0;
+	std::uint64_t branchMisses = 0;
+public:
+	CounterValues &operator+=(const CounterValues &o) {
+		cycles += o.cycles;
+		instructions += o.instructions;
+		llcMisses += o.llcMisses;
+		branchMisses += o.branchMisses;
+		return *this;
+	}
+
+	// Saturates at zero, scaled readings of a multiplexed counter are estimates and may step back.
+	friend CounterValues operator-(const CounterValues &a, const CounterValues &b) {
+		auto sub = [](std::uint64_t x, std::uint64_t y) { return x > y ? x - y : 0; };
+		return CounterValues{sub(a.cycles, b.cycles), sub(a.instructions, b.instructions),
+		                     sub(a.llcMisses, b.llcMisses), sub(a.branchMisses, b.branchMisses)};
+	}
+};
+
+/**
+ * @brief Hardware counters of the calling thread, read with Linux perf_event_open.
+ * 			Only user space is counted, so perf_event_paranoid up to 2 suffices. The events are opened
+ * 			as one group led by the cycle counter, so the kernel schedules them together and ratios
+ * 			such as IPC compare counts of the same time window; one read returns all of them.
+ * 			An event that cannot join the group is opened on its own instead, and an event the
+ * 			machine or the permissions do not provide at all (e.g. in a VM or a container without
+ * 			the syscall) reads as zero and available(event) is false.
+ * 			Counts are scaled when the kernel multiplexes the counters.
+ */
+class PerfCounters {
+public:
+	enum Event { Cycles, Instructions, LlcMisses, BranchMisses, NumEvents };
+
+	// Opens the counters for the calling thread, they run from now on.
+	PerfCounters() {
+		const std::uint64_t configs[NumEvents] = {
+			PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+			PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES};
+		for(int i = 0; i < NumEvents; ++i) {
+			// the first event that opens leads the group
+			const int leader = groupSize > 0 ? fds[groupOrder[0]] : -1;
+			fds[i] = open(configs[i], leader, true);
+			if(fds[i] >= 0) {
+				grouped[i] = true;
+				groupOrder[groupSize++] = static_cast<Event>(i);
+			} else if(groupSize > 0) {
+				// cannot join the group, count it on its own
+				fds[i] = open(configs[i], -1, false);
+			}
+		}
+	}
+
+	PerfCounters(const PerfCounters&) = delete;
+	PerfCounters &operator=(const PerfCounters&) = delete;
+
+	~PerfCounters() {
+		for(int fd : fds) if(fd >= 0) close(fd);
+	}
+
+	bool available(Event e) const { return fds[e] >= 0; }
+
+	// True if at least one event could be opened.
+	bool available() const {
+		return std::any_of(std::begin(fds), std::end(fds), [](int fd) { return fd >= 0; });
+	}
+
+	// Counts since construction.
+	CounterValues read() const {
+		std::uint64_t values[NumEvents] = {};
+		if(groupSize > 0) {
+			// number of events, time enabled, time running, then the values in the order they joined
+			std::uint64_t buf[3 + NumEvents];
+			const auto bytes = static_cast<ssize_t>((3 + groupSize) * sizeof(std::uint64_t));
+			if(::read(fds[groupOrder[0]], buf, bytes) == bytes && buf[0] == groupSize) {
+				for(std::size_t k = 0; k < groupSize; ++k) values[groupOrder[k]] = scale(buf[3 + k], buf[1], buf[2]);
+			}
+		}
+		for(int i = 0; i < NumEvents; ++i) {
+			if(fds[i] < 0 || grouped[i]) continue;
+			std::uint64_t buf[3]; // value, time enabled, time running
+			if(::read(fds[i], buf, sizeof(buf)) == sizeof(buf)) values[i] = scale(buf[0], buf[1], buf[2]);
+		}
+		return CounterValues{values[Cycles], values[Instructions], values[LlcMisses], values[BranchMisses]};
+	}
+private:
+	static int open(std::uint64_t config, int groupFd, bool inGroup) {
+		perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = config;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+		if(inGroup) attr.read_format |= PERF_FORMAT_GROUP;
+		return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, groupFd, 0));
+	}
+
+	// Extrapolates a count to the whole time the counter was enabled.
+	static std::uint64_t scale(std::uint64_t value, std::uint64_t enabled, std::uint64_t running) {
+		if(running == 0) return 0;
+		if(enabled == running) return value;
+		return static_cast<std::uint64_t>(static_cast<double>(value) * enabled / running);
+	}
+private:
+	int fds[NumEvents];
+	// whether fds[i] is in the group led by fds[groupOrder[0]], and the order the events joined it
+	bool grouped[NumEvents] = {};
+	Event groupOrder[NumEvents] = {};
+	std::size_t groupSize = 0;
+};
+
+/**
+ * @brief Totals of all runs of one named phase, see ScopedPhase.
+ */
+struct PhaseStats {
+	std::string name;
+	std::size_t calls = 0;
+	std::uint64_t nanoseconds = 0;
+	CounterValues counters;
+};
+
+namespace detail {
+
+// Counters of the calling thread, opened on first use.
+inline const PerfCounters &threadCounters() {
+	thread_local PerfCounters counters;
+	return counters;
+}
+
+class PhaseRegistry {
+public:
+	void add(const char *name, std::uint64_t nanoseconds, const CounterValues &counters) {
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = std::find_if(phases.begin(), phases.end(), [&](const PhaseStats &p) { return p.name == name; });
+		if(it == phases.end()) it = phases.insert(phases.end(), PhaseStats{name, 0, 0, {}});
+		++it->calls;
+		it->nanoseconds += nanoseconds;
+		it->counters += counters;
+	}
+
+	std::vector<PhaseStats> snapshot() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return phases;
+	}
+
+	void reset() {
+		std::lock_guard<std::mutex> lock(mutex);
+		phases.clear();
+	}
+private:
+	std::mutex mutex;
+	// in order of first completion, there are only a handful of phases
+	std::vector<PhaseStats> phases;
+};
+
+inline PhaseRegistry &phaseRegistry() {
+	static PhaseRegistry registry;
+	return registry;
+}
+
+} // namespace detail
+
+/**
+ * @brief Adds the wall time and hardware counts between construction and destruction to the totals
+ * 			of the phase `name`, which must outlive the object. Phases may nest, an inner phase
+ * 			is also counted in the outer one. The counters only follow the calling thread; other
+ * 			threads working for the phase add their counts through a PhaseWorker, as the workers
+ * 			of the library's parallel algorithms do. Usually used through GRAPH_PHASE, see
+ * 			instrumentation.hpp.
+ */
+class ScopedPhase {
+public:
+	explicit ScopedPhase(const char *name)
+		: name(name), parent(innermost()), startCounters(detail::threadCounters().read()),
+		  startTime(std::chrono::steady_clock::now()) {
+		innermost() = this;
+	}
+
+	ScopedPhase(const ScopedPhase&) = delete;
+	ScopedPhase &operator=(const ScopedPhase&) = delete;
+
+	~ScopedPhase() {
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - startTime).count();
+		CounterValues counters = detail::threadCounters().read() - startCounters;
+		{
+			std::lock_guard<std::mutex> lock(workerMutex);
+			counters += workerCounters;
+		}
+		detail::phaseRegistry().add(name, static_cast<std::uint64_t>(ns), counters);
+		innermost() = parent;
+	}
+
+	// The innermost phase running on the calling thread, or nullptr.
+	static ScopedPhase *current() { return innermost(); }
+
+	// Adds the counts of another thread working for this phase, to it and the phases enclosing it.
+	void addWorkerCounts(const CounterValues &counters) {
+		for(ScopedPhase *p = this; p; p = p->parent) {
+			std::lock_guard<std::mutex> lock(p->workerMutex);
+			p->workerCounters += counters;
+		}
+	}
+private:
+	static ScopedPhase *&innermost() {
+		thread_local ScopedPhase *phase = nullptr;
+		return phase;
+	}
+private:
+	const char *name;
+	ScopedPhase *parent;
+	CounterValues startCounters;
+	std::chrono::steady_clock::time_point startTime;
+	std::mutex workerMutex;
+	CounterValues workerCounters;
+};
+
+/**
+ * @brief Adds the hardware counts of the calling thread between construction and destruction to
+ * 			`phase`, a phase running on another thread that outlives the object. Does nothing if
+ * 			`phase` is nullptr.
+ */
+class PhaseWorker {
+public:
+	explicit PhaseWorker(ScopedPhase *phase)
+		: phase(phase), startCounters(phase ? detail::threadCounters().read() : CounterValues{}) {}
+
+	PhaseWorker(const PhaseWorker&) = delete;
+	PhaseWorker &operator=(const PhaseWorker&) = delete;
+
+	~PhaseWorker() {
+		if(phase) phase->addWorkerCounts(detail::threadCounters().read() - startCounters);
+	}
+private:
+	ScopedPhase *phase;
+	CounterValues startCounters;
+};
+
+/**
+ * @return the totals of every phase run so far, in order of first completion.
+ */
+inline std::vector<PhaseStats> phaseReport() {
+	return detail::phaseRegistry().snapshot();
+}
+
+// Clears the totals of all phases.
+inline void resetPhaseReport() {
+	detail::phaseRegistry().reset();
+}
+
+/**
+ * @brief Prints phaseReport() as a table with the instructions per cycle and the misses per thousand
+ * 			instructions. The counter columns are zero if perf_event_open is unavailable. The counts
+ * 			of a parallel phase are summed over its threads, so its cycles can exceed the wall time
+ * 			times the clock rate, while IPC and MPKI stay per thread averages.
+ */
+inline std::ostream &printPhaseReport(std::ostream &s) {
+	const std::ios_base::fmtflags flags = s.flags();
+	const std::streamsize precision = s.precision();
+	s << std::left << std::setw(24) << "phase" << std::right << std::setw(8) << "calls"
+	  << std::setw(14) << "ms" << std::setw(16) << "cycles" << std::setw(16) << "instructions"
+	  << std::setw(8) << "IPC" << std::setw(14) << "LLC misses" << std::setw(14) << "branch misses"
+	  << std::setw(12) << "LLC MPKI" << "\n";
+	for(const PhaseStats &p : phaseReport()) {
+		const CounterValues &c = p.counters;
+		const double ipc = c.cycles ? static_cast<double>(c.instructions) / c.cycles : 0;
+		const double mpki = c.instructions ? 1000.0 * c.llcMisses / c.instructions : 0;
+		s << std::left << std::setw(24) << p.name << std::right << std::setw(8) << p.calls
+		  << std::setw(14) << std::fixed << std::setprecision(3) << p.nanoseconds / 1e6
+		  << std::setw(16) << c.cycles << std::setw(16) << c.instructions
+		  << std::setw(8) << std::setprecision(2) << ipc << std::setw(14) << c.llcMisses
+		  << std::setw(14) << c.branchMisses << std::setw(12) << mpki << "\n";
+	}
+	s.flags(flags);
+	s.precision(precision);
+	return s;
+}
+
+} // namespace graph
+
+#endif // GRAPH_PERF_COUNTERS_HPP
@@ -1,11 +1,31 @@
 #ifndef GRAPH_PROPERTIES_HPP
 #define GRAPH_PROPERTIES_HPP
 
+#include "traits.hpp"
+
+#include <type_traits>
+
 namespace graph {
 
 // An empty helper class to denote that no property should be attached.
 struct NoProp {};
 
+namespace detail {
+
+// True if the graph `G` attaches a property to each vertex.
+template<typename G>
+inline constexpr bool hasVertexProp =
+	!std::is_void_v<typename Traits<G>::VertexProp>
+	&& !std::is_same_v<typename Traits<G>::VertexProp, NoProp>;
+
+// True if the graph `G` attaches a property to each edge.
+template<typename G>
+inline constexpr bool hasEdgeProp =
+	!std::is_void_v<typename Traits<G>::EdgeProp>
+	&& !std::is_same_v<typename Traits<G>::EdgeProp, NoProp>;
+
+} // namespace detail
+
 } // namespace graph
 
 #endif // GRAPH_PROPERTIES_HPP
@@ -0,0 +1,302 @@
+#ifndef GRAPH_PROPERTY_MAP_HPP
+#define GRAPH_PROPERTY_MAP_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief A map from the index of a vertex or edge (as given by getIndex()) to a value of type `T`,
+ * 			read with get(map, i) and written with put(map, i, value).
+ * 			Maps are external to the graph, so an algorithm can take its output or scratch state
+ * 			as a map and the caller decides about reuse across runs and the memory/speed trade-off.
+ */
+template<typename Map, typename T>
+concept ReadWritePropertyMap = requires(Map &map, std::size_t i, T value) {
+	{ get(map, i) } -> std::convertible_to<T>;
+	put(map, i, value);
+};
+
+/**
+ * @brief Property map backed by a std::vector<T>, the fastest choice for dense keys.
+ */
+template<typename T>
+struct VectorPropertyMap {
+	// std::vector<bool> hands out proxies, not references; BitPropertyMap packs bools as densely.
+	static_assert(!std::is_same_v<T, bool>, "use BitPropertyMap (or VectorPropertyMap<char>) for bools");
+
+	VectorPropertyMap() = default;
+	explicit VectorPropertyMap(std::size_t n, const T &init = T()) : values(n, init) {}
+
+	std::size_t size() const { return values.size(); }
+
+	// Resizes the map to `n` keys and sets every value to `value`, reusing the allocation.
+	void assign(std::size_t n, const T &value) { values.assign(n, value); }
+
+	T &operator[](std::size_t i) { return values[i]; }
+	const T &operator[](std::size_t i) const { return values[i]; }
+
+	friend const T &get(const VectorPropertyMap &map, std::size_t i) {
+		return map.values[i];
+	}
+
+	friend void put(VectorPropertyMap &map, std::size_t i, const T &value) {
+		map.values[i] = value;
+	}
+private:
+	std::vector<T> values;
+};
+
+/**
+ * @brief Property map of bools packed 64 per word, one bit per key.
+ */
+struct BitPropertyMap {
+	BitPropertyMap() = default;
+	explicit BitPropertyMap(std::size_t n, bool init = false) { assign(n, init); }
+
+	std::size_t size() const { return n; }
+
+	// Resizes the map to `n` keys and sets every bit to `value`, reusing the allocation.
+	void assign(std::size_t n, bool value) {
+		this->n = n;
+		words.assign((n + 63) / 64, value ? ~std::uint64_t(0) : 0);
+	}
+
+	friend bool get(const BitPropertyMap &map, std::size_t i) {
+		return (map.words[i / 64] >> (i % 64)) & 1;
+	}
+
+	friend void put(BitPropertyMap &map, std::size_t i, bool value) {
+		const std::uint64_t bit = std::uint64_t(1) << (i % 64);
+		if(value) map.words[i / 64] |= bit;
+		else map.words[i / 64] &= ~bit;
+	}
+private:
+	std::size_t n = 0;
+	std::vector<std::uint64_t> words;
+};
+
+/**
+ * @brief Property map of values with at most four states, e.g. DFSColour, packed 32 per word.
+ * 			`T` must convert to and from an integer in [0, 4) with static_cast.
+ */
+template<typename T>
+struct TwoBitPropertyMap {
+	TwoBitPropertyMap() = default;
+	explicit TwoBitPropertyMap(std::size_t n, T init = T()) { assign(n, init); }
+
+	std::size_t size() const { return n; }
+
+	// Resizes the map to `n` keys and sets every value to `value`, reusing the allocation.
+	void assign(std::size_t n, T value) {
+		std::uint64_t pattern = static_cast<std::uint64_t>(value) & 3;
+		for(unsigned shift = 2; shift < 64; shift *= 2) pattern |= pattern << shift;
+		this->n = n;
+		words.assign((n + 31) / 32, pattern);
+	}
+
+	friend T get(const TwoBitPropertyMap &map, std::size_t i) {
+		return static_cast<T>((map.words[i / 32] >> (2 * (i % 32))) & 3);
+	}
+
+	friend void put(TwoBitPropertyMap &map, std::size_t i, T value) {
+		const unsigned shift = 2 * (i % 32);
+		std::uint64_t &w = map.words[i / 32];
+		w = (w & ~(std::uint64_t(3) << shift)) | ((static_cast<std::uint64_t>(value) & 3) << shift);
+	}
+private:
+	std::size_t n = 0;
+	std::vector<std::uint64_t> words;
+};
+
+/**
+ * @brief Property map where every key carries the generation it was written in, and keys from an
+ * 			older generation read as the default value. clear() starts a new generation, so resetting
+ * 			the map between traversals is O(1) and a traversal only pays for the keys it touches.
+ */
+template<typename T>
+struct GenerationPropertyMap {
+	GenerationPropertyMap() = default;
+	explicit GenerationPropertyMap(std::size_t n, T defaultValue = T())
+		: defaultValue(defaultValue), stamps(n, 0), values(n) {}
+
+	std::size_t size() const { return stamps.size(); }
+
+	// Resets every key to the default value.
+	void clear() {
+		if(++generation == 0) {
+			// the stamps wrapped around, so old stamps could match again
+			std::fill(stamps.begin(), stamps.end(), 0);
+			generation = 1;
+		}
+	}
+
+	friend T get(const GenerationPropertyMap &map, std::size_t i) {
+		return map.stamps[i] == map.generation ? map.values[i] : map.defaultValue;
+	}
+
+	friend void put(GenerationPropertyMap &map, std::size_t i, const T &value) {
+		map.stamps[i] = map.generation;
+		map.values[i] = value;
+	}
+private:
+	T defaultValue{};
+	std::uint32_t generation = 1;
+	std::vector<std::uint32_t> stamps;
+	std::vector<T> values;
+};
+
+/**
+ * @brief Set of indices in [0, n) with an O(1) clear(): a key is in the set if its stamp equals
+ * 			the current generation. Also a bool property map, so it can replace a BitPropertyMap
+ * 			for repeated small traversals on a big graph.
+ */
+struct GenerationVisitedSet {
+	GenerationVisitedSet() = default;
+	explicit GenerationVisitedSet(std::size_t n) : stamps(n, 0) {}
+
+	std::size_t size() const { return stamps.size(); }
+
+	bool contains(std::size_t i) const { return stamps[i] == generation; }
+
+	/**
+	 * @return true if `i` was not in the set before.
+	 */
+	bool insert(std::size_t i) {
+		if(stamps[i] == generation) return false;
+		stamps[i] = generation;
+		return true;
+	}
+
+	// Empties the set.
+	void clear() {
+		if(++generation == 0) {
+			std::fill(stamps.begin(), stamps.end(), 0);
+			generation = 1;
+		}
+	}
+
+	friend bool get(const GenerationVisitedSet &set, std::size_t i) {
+		return set.contains(i);
+	}
+
+	friend void put(GenerationVisitedSet &set, std::size_t i, bool value) {
+		set.stamps[i] = value ? set.generation : 0;
+	}
+private:
+	std::uint32_t generation = 1;
+	std::vector<std::uint32_t> stamps;
+};
+
+/**
+ * @brief Property map of std::atomic<T> for algorithms writing from several threads.
+ * 			get() and put() use relaxed ordering; use compareExchange() to claim a key.
+ */
+template<typename T>
+struct AtomicPropertyMap {
+	AtomicPropertyMap() = default;
+	explicit AtomicPropertyMap(std::size_t n, T init = T()) { assign(n, init); }
+
+	std::size_t size() const { return n; }
+
+	// Resizes the map to `n` keys and sets every value to `value`, reusing the allocation if possible.
+	void assign(std::size_t n, T value) {
+		if(n != this->n) values = std::make_unique<std::atomic<T>[]>(n);
+		this->n = n;
+		for(std::size_t i = 0; i < n; ++i) values[i].store(value, std::memory_order_relaxed);
+	}
+
+	friend T get(const AtomicPropertyMap &map, std::size_t i) {
+		return map.values[i].load(std::memory_order_relaxed);
+	}
+
+	friend void put(AtomicPropertyMap &map, std::size_t i, T value) {
+		map.values[i].store(value, std::memory_order_relaxed);
+	}
+
+	/**
+	 * @brief Sets the value of `i` to `desired` if it is `expected`.
+	 * @return true if this call changed the value.
+	 */
+	friend bool compareExchange(AtomicPropertyMap &map, std::size_t i, T expected, T desired) {
+		return map.values[i].compare_exchange_strong(expected, desired, std::memory_order_acq_rel);
+	}
+private:
+	std::size_t n = 0;
+	std::unique_ptr<std::atomic<T>[]> values;
+};
+
+/**
+ * @brief Property map storing only the keys that were written in a hash table, every other key
+ * 			reads as the default value. Memory is proportional to the number of written keys,
+ * 			which suits traversals that touch a small part of a big graph.
+ */
+template<typename T>
+struct SparsePropertyMap {
+	explicit SparsePropertyMap(T defaultValue = T()) : defaultValue(defaultValue) {}
+
+	// Number of keys that were written.
+	std::size_t size() const { return values.size(); }
+
+	// Resets every key to the default value, keeping the buckets.
+	void clear() { values.clear(); }
+
+	friend const T &get(const SparsePropertyMap &map, std::size_t i) {
+		auto it = map.values.find(i);
+		return it == map.values.end() ? map.defaultValue : it->second;
+	}
+
+	friend void put(SparsePropertyMap &map, std::size_t i, const T &value) {
+		map.values.insert_or_assign(i, value);
+	}
+private:
+	T defaultValue;
+	std::unordered_map<std::size_t, T> values;
+};
+
+namespace detail {
+
+/**
+ * @brief Property map view of a caller's std::vector, so the overloads of an algorithm taking a
+ * 			vector can forward to the one taking a map. Puts from several threads are fine as long as
+ * 			they go to distinct keys.
+ */
+template<typename T>
+struct VectorRefMap {
+	static_assert(!std::is_same_v<T, bool>, "std::vector<bool> hands out proxies, not references");
+
+	friend const T &get(const VectorRefMap &map, std::size_t i) { return (*map.values)[i]; }
+	friend void put(VectorRefMap &map, std::size_t i, const T &value) { (*map.values)[i] = value; }
+
+	std::vector<T> *values;
+};
+
+/**
+ * @brief Property map that drops every put and reads as `T()`, for outputs the caller does not want.
+ */
+template<typename T>
+struct NullPropertyMap {
+	friend T get(const NullPropertyMap&, std::size_t) { return T(); }
+	friend void put(NullPropertyMap&, std::size_t, const T&) {}
+};
+
+} // namespace detail
+
+/**
+ * @return a VectorPropertyMap with one value per vertex of `g`.
+ */
+template<typename T, typename Graph>
+VectorPropertyMap<T> makeVertexMap(const Graph &g, const T &init = T()) {
+	return VectorPropertyMap<T>(numVertices(g), init);
+}
+
+} // namespace graph
+
+#endif // GRAPH_PROPERTY_MAP_HPP
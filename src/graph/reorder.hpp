@@ -0,0 +1,328 @@
+#ifndef GRAPH_REORDER_HPP
+#define GRAPH_REORDER_HPP
+
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "properties.hpp"
+#include "property_map.hpp"
+#include "transpose.hpp"
+#include "traits.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <queue>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Builds a copy of `g` with vertex `v` renumbered to `permutation[getIndex(v, g)]`.
+ * 			Vertex and edge properties move with their vertices and edges. The edges are counting
+ * 			sorted by new source, so the edge list of the result follows the new vertex order.
+ * @tparam Graph graph type with a constructor taking the number of vertices and addEdges(), e.g. AdjacencyList
+ * @param g graph to renumber
+ * @param permutation a permutation of [0, numVertices(g)), mapping old to new vertex indices
+ * @param edgeMap property map keyed by the position `i` of an edge in edges(g), is set to the new
+ * 			storedEdgeIdx of that edge. The map is written from the calling thread only, so any map works.
+ * @return the renumbered graph.
+ */
+template<typename Graph, ReadWritePropertyMap<std::size_t> EdgeMap>
+Graph reorder(const Graph &g, const std::vector<std::size_t> &permutation, EdgeMap &edgeMap) {
+	GRAPH_PHASE("reorder");
+	const auto es = detail::edgeVector(g);
+	std::vector<std::size_t> positions(es.size());
+	std::iota(positions.begin(), positions.end(), 0);
+	positions = detail::countingSort(positions, numVertices(g), [&](std::size_t i) {
+		return permutation[getIndex(source(es[i], g), g)];
+	});
+
+	std::vector<detail::EdgeTuple<Graph>> relabelled(es.size());
+	detail::parallelFor(positions.size(), [&](std::size_t i) {
+		const auto &e = es[positions[i]];
+		relabelled[i] = detail::makeEdgeTuple(permutation[getIndex(source(e, g), g)],
+		                                      permutation[getIndex(target(e, g), g)], e, g);
+	});
+	for(std::size_t i = 0; i < positions.size(); ++i) put(edgeMap, positions[i], i);
+
+	Graph res(numVertices(g));
+	if constexpr(detail::hasVertexProp<Graph>) {
+		for(auto v : vertices(g)) res[permutation[getIndex(v, g)]] = g[v];
+	}
+	addEdges(relabelled, res);
+	return res;
+}
+
+/**
+ * @brief See above, with `edgeMap` resized to numEdges(g) and `edgeMap[i]` set for the edge at
+ * 			position `i` of edges(g).
+ */
+template<typename Graph>
+Graph reorder(const Graph &g, const std::vector<std::size_t> &permutation, std::vector<std::size_t> &edgeMap) {
+	edgeMap.resize(numEdges(g));
+	detail::VectorRefMap<std::size_t> map{&edgeMap};
+	return reorder(g, permutation, map);
+}
+
+/**
+ * @brief See above, without reporting where the edges moved.
+ */
+template<typename Graph>
+Graph reorder(const Graph &g, const std::vector<std::size_t> &permutation) {
+	detail::NullPropertyMap<std::size_t> edgeMap;
+	return reorder(g, permutation, edgeMap);
+}
+
+namespace detail {
+
+/**
+ * @brief CSR of the neighbours of every vertex, ignoring edge direction and self-loops,
+ * 			used by the ordering heuristics which all treat the graph as undirected.
+ */
+struct UndirectedAdjacency {
+	template<typename Graph>
+	explicit UndirectedAdjacency(const Graph &g) : offsets(numVertices(g) + 1, 0) {
+		for(auto e : edges(g)) {
+			const auto s = getIndex(source(e, g), g), t = getIndex(target(e, g), g);
+			if(s == t) continue;
+			++offsets[s + 1];
+			++offsets[t + 1];
+		}
+		std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+		targets.resize(offsets.back());
+		std::vector<std::size_t> fill(offsets.begin(), offsets.end() - 1);
+		for(auto e : edges(g)) {
+			const auto s = getIndex(source(e, g), g), t = getIndex(target(e, g), g);
+			if(s == t) continue;
+			targets[fill[s]++] = t;
+			targets[fill[t]++] = s;
+		}
+	}
+
+	std::size_t size() const { return offsets.size() - 1; }
+	std::size_t degree(std::size_t v) const { return offsets[v + 1] - offsets[v]; }
+	const std::size_t *begin(std::size_t v) const { return targets.data() + offsets[v]; }
+	const std::size_t *end(std::size_t v) const { return targets.data() + offsets[v + 1]; }
+
+	std::vector<std::size_t> offsets;
+	std::vector<std::size_t> targets;
+};
+
+/**
+ * @brief Inverts a visiting order (order[i] is the i'th vertex) into a permutation for reorder().
+ */
+inline std::vector<std::size_t> orderToPermutation(const std::vector<std::size_t> &order) {
+	std::vector<std::size_t> perm(order.size());
+	for(std::size_t i = 0; i < order.size(); ++i) perm[order[i]] = i;
+	return perm;
+}
+
+/**
+ * @brief Appends the vertices reachable from `start` to `order` in BFS order.
+ * 			With `byDegree`, the neighbours of a vertex are visited by increasing degree (Cuthill-McKee).
+ */
+template<typename VisitedMap>
+void bfsFrom(const UndirectedAdjacency &adj, std::size_t start, bool byDegree,
+             VisitedMap &visited, std::vector<std::size_t> &order) {
+	std::size_t head = order.size();
+	put(visited, start, true);
+	order.push_back(start);
+	std::vector<std::size_t> next;
+	while(head != order.size()) {
+		const std::size_t u = order[head++];
+		next.clear();
+		for(auto v = adj.begin(u); v != adj.end(u); ++v) {
+			if(get(visited, *v)) continue;
+			put(visited, *v, true);
+			next.push_back(*v);
+		}
+		if(byDegree) {
+			std::stable_sort(next.begin(), next.end(), [&](std::size_t a, std::size_t b) {
+				return adj.degree(a) < adj.degree(b);
+			});
+		}
+		order.insert(order.end(), next.begin(), next.end());
+	}
+}
+
+} // namespace detail
+
+/**
+ * @brief Orders the vertices by decreasing out degree, so hubs are packed together at the front.
+ * 			Vertices with equal degree keep their relative order.
+ * @return a permutation for reorder().
+ */
+template<typename Graph>
+std::vector<std::size_t> degreeSortOrder(const Graph &g) {
+	GRAPH_PHASE("degreeSortOrder");
+	std::vector<std::size_t> order(numVertices(g)), degree(numVertices(g));
+	std::size_t maxDegree = 0;
+	for(auto v : vertices(g)) {
+		degree[getIndex(v, g)] = outDegree(v, g);
+		maxDegree = std::max(maxDegree, degree[getIndex(v, g)]);
+	}
+	std::iota(order.begin(), order.end(), 0);
+	order = detail::countingSort(order, maxDegree + 1, [&](std::size_t v) {
+		return maxDegree - degree[v];
+	});
+	return detail::orderToPermutation(order);
+}
+
+/**
+ * @brief Orders the vertices by BFS, ignoring edge direction. Every connected component is
+ * 			started from its lowest numbered vertex, unless `start` is in it.
+ * @param visited bool property map with a key for every vertex index, all false; every key is
+ * 			true afterwards
+ * @return a permutation for reorder().
+ */
+template<typename Graph, ReadWritePropertyMap<bool> VisitedMap>
+std::vector<std::size_t> bfsOrder(const Graph &g, typename Traits<Graph>::VertexDescriptor start, VisitedMap &visited) {
+	GRAPH_PHASE("bfsOrder");
+	detail::UndirectedAdjacency adj(g);
+	std::vector<std::size_t> order;
+	order.reserve(adj.size());
+	if(adj.size() > 0) detail::bfsFrom(adj, getIndex(start, g), false, visited, order);
+	for(std::size_t v = 0; v < adj.size(); ++v)
+		if(!get(visited, v)) detail::bfsFrom(adj, v, false, visited, order);
+	return detail::orderToPermutation(order);
+}
+
+/**
+ * @brief See above, with a visited map of its own.
+ */
+template<typename Graph>
+std::vector<std::size_t> bfsOrder(const Graph &g, typename Traits<Graph>::VertexDescriptor start) {
+	VectorPropertyMap<char> visited(numVertices(g), false);
+	return bfsOrder(g, start, visited);
+}
+
+/**
+ * @brief Reverse Cuthill-McKee ordering, ignoring edge direction, which reduces the bandwidth of
+ * 			the adjacency matrix. Every connected component is started from a vertex of minimum degree,
+ * 			and the neighbours of a vertex are visited by increasing degree.
+ * @param visited bool property map with a key for every vertex index, all false; every key is
+ * 			true afterwards
+ * @return a permutation for reorder().
+ */
+template<typename Graph, ReadWritePropertyMap<bool> VisitedMap>
+std::vector<std::size_t> reverseCuthillMcKeeOrder(const Graph &g, VisitedMap &visited) {
+	GRAPH_PHASE("reverseCuthillMcKeeOrder");
+	detail::UndirectedAdjacency adj(g);
+	std::vector<std::size_t> byDegree(adj.size());
+	std::iota(byDegree.begin(), byDegree.end(), 0);
+	std::stable_sort(byDegree.begin(), byDegree.end(), [&](std::size_t a, std::size_t b) {
+		return adj.degree(a) < adj.degree(b);
+	});
+	std::vector<std::size_t> order;
+	order.reserve(adj.size());
+	for(auto v : byDegree)
+		if(!get(visited, v)) detail::bfsFrom(adj, v, true, visited, order);
+	std::reverse(order.begin(), order.end());
+	return detail::orderToPermutation(order);
+}
+
+/**
+ * @brief See above, with a visited map of its own.
+ */
+template<typename Graph>
+std::vector<std::size_t> reverseCuthillMcKeeOrder(const Graph &g) {
+	VectorPropertyMap<char> visited(numVertices(g), false);
+	return reverseCuthillMcKeeOrder(g, visited);
+}
+
+/**
+ * @brief Greedy Gorder-style ordering: the next vertex placed is the unplaced vertex with the highest
+ * 			score against the last `window` placed vertices, where a vertex scores one for every placed
+ * 			neighbour and one for every common neighbour (siblings). Edge direction is ignored, and the
+ * 			sibling term is only collected through vertices of degree at most `hubDegree`, so hubs do not
+ * 			make the ordering quadratic. Scores live in a lazy max-heap.
+ * @param g graph to order
+ * @param placed bool property map with a key for every vertex index, all false; every key is
+ * 			true afterwards
+ * @param window number of recently placed vertices that contribute to the scores
+ * @param hubDegree maximum degree of a common neighbour for the sibling term
+ * @return a permutation for reorder().
+ */
+template<typename Graph, ReadWritePropertyMap<bool> PlacedMap>
+std::vector<std::size_t> gorderOrder(const Graph &g, PlacedMap &placed, std::size_t window = 5, std::size_t hubDegree = 64) {
+	GRAPH_PHASE("gorderOrder");
+	detail::UndirectedAdjacency adj(g);
+	const std::size_t n = adj.size();
+	std::vector<std::int64_t> score(n, 0);
+	std::priority_queue<std::pair<std::int64_t, std::size_t>> heap;
+
+	auto update = [&](std::size_t v, std::int64_t delta) {
+		auto bump = [&](std::size_t u) {
+			if(get(placed, u)) return;
+			score[u] += delta;
+			heap.emplace(score[u], u);
+		};
+		for(auto w = adj.begin(v); w != adj.end(v); ++w) {
+			bump(*w);
+			if(adj.degree(*w) > hubDegree) continue;
+			for(auto u = adj.begin(*w); u != adj.end(*w); ++u)
+				if(*u != v) bump(*u);
+		}
+	};
+
+	std::vector<std::size_t> byDegree(n);
+	std::iota(byDegree.begin(), byDegree.end(), 0);
+	std::stable_sort(byDegree.begin(), byDegree.end(), [&](std::size_t a, std::size_t b) {
+		return adj.degree(a) > adj.degree(b);
+	});
+	std::size_t nextSeed = 0;
+
+	std::vector<std::size_t> order;
+	order.reserve(n);
+	while(order.size() < n) {
+		std::size_t v = n;
+		while(!heap.empty()) {
+			auto [s, u] = heap.top();
+			heap.pop();
+			if(!get(placed, u) && s == score[u]) {
+				v = u;
+				break;
+			}
+		}
+		// no candidate related to the window: continue with the highest degree unplaced vertex
+		if(v == n) {
+			while(get(placed, byDegree[nextSeed])) ++nextSeed;
+			v = byDegree[nextSeed];
+		}
+		put(placed, v, true);
+		order.push_back(v);
+		update(v, 1);
+		if(order.size() > window) update(order[order.size() - 1 - window], -1);
+	}
+	return detail::orderToPermutation(order);
+}
+
+/**
+ * @brief See above, with a placed map of its own.
+ */
+template<typename Graph>
+std::vector<std::size_t> gorderOrder(const Graph &g, std::size_t window = 5, std::size_t hubDegree = 64) {
+	VectorPropertyMap<char> placed(numVertices(g), false);
+	return gorderOrder(g, placed, window, hubDegree);
+}
+
+/**
+ * @brief Locality measure for comparing orderings: the mean over all edges of log2(1 + |src - tar|),
+ * 			using getIndex() numbers. Lower values mean the endpoints of edges are stored closer together.
+ */
+template<typename Graph>
+double averageLogGap(const Graph &g) {
+	if(numEdges(g) == 0) return 0;
+	double sum = 0;
+	for(auto e : edges(g)) {
+		const auto s = getIndex(source(e, g), g), t = getIndex(target(e, g), g);
+		sum += std::log2(1.0 + static_cast<double>(s > t ? s - t : t - s));
+	}
+	return sum / static_cast<double>(numEdges(g));
+}
+
+} // namespace graph
+
+#endif // GRAPH_REORDER_HPP
@@ -0,0 +1,102 @@
+#ifndef GRAPH_REVERSE_GRAPH_HPP
+#define GRAPH_REVERSE_GRAPH_HPP
+
+#include "concepts.hpp"
+#include "tags.hpp"
+#include "traits.hpp"
+
+#include <type_traits>
+
+namespace graph {
+
+/**
+ * @brief Zero-copy view of a bidirectional graph with every edge reversed.
+ * 			The out edges of a vertex are the in edges of the underlying graph and vice versa,
+ * 			and source() and target() are swapped. Descriptors are those of the underlying graph,
+ * 			so edge properties can be looked up in either.
+ * @tparam Graph the underlying BidirectionalGraph type, which must outlive the view
+ */
+template<typename Graph>
+struct ReverseGraph {
+	static_assert(BidirectionalGraph<Graph>);
+public: // Graph
+	using VertexDescriptor = typename Traits<Graph>::VertexDescriptor;
+	using EdgeDescriptor = typename Traits<Graph>::EdgeDescriptor;
+	using DirectedCategory = graph::tags::Bidirectional;
+public: // PropertyGraph
+	using VertexProp = typename Traits<Graph>::VertexProp;
+	using EdgeProp = typename Traits<Graph>::EdgeProp;
+public: // VertexListGraph, EdgeListGraph, IncidenceGraph and BidirectionalGraph
+	using VertexRange = typename Traits<Graph>::VertexRange;
+	using EdgeRange = typename Traits<Graph>::EdgeRange;
+	using OutEdgeRange = typename Traits<Graph>::InEdgeRange;
+	using InEdgeRange = typename Traits<Graph>::OutEdgeRange;
+public:
+	explicit ReverseGraph(const Graph &g) : g(&g) {}
+private:
+	const Graph *g;
+public: // Graph
+	friend VertexDescriptor source(const EdgeDescriptor &e, const ReverseGraph &rg) {
+		return target(e, *rg.g);
+	}
+
+	friend VertexDescriptor target(const EdgeDescriptor &e, const ReverseGraph &rg) {
+		return source(e, *rg.g);
+	}
+public: // VertexListGraph
+	friend std::size_t numVertices(const ReverseGraph &rg) {
+		return numVertices(*rg.g);
+	}
+
+	friend VertexRange vertices(const ReverseGraph &rg) {
+		return vertices(*rg.g);
+	}
+public: // EdgeListGraph
+	friend std::size_t numEdges(const ReverseGraph &rg) {
+		return numEdges(*rg.g);
+	}
+
+	friend EdgeRange edges(const ReverseGraph &rg) {
+		return edges(*rg.g);
+	}
+public: // IncidenceGraph
+	friend OutEdgeRange outEdges(VertexDescriptor v, const ReverseGraph &rg) {
+		return inEdges(v, *rg.g);
+	}
+
+	friend std::size_t outDegree(VertexDescriptor v, const ReverseGraph &rg) {
+		return inDegree(v, *rg.g);
+	}
+public: // BidirectionalGraph
+	friend InEdgeRange inEdges(VertexDescriptor v, const ReverseGraph &rg) {
+		return outEdges(v, *rg.g);
+	}
+
+	friend std::size_t inDegree(VertexDescriptor v, const ReverseGraph &rg) {
+		return outDegree(v, *rg.g);
+	}
+public: // Other
+	friend std::size_t getIndex(VertexDescriptor v, const ReverseGraph &rg) {
+		return getIndex(v, *rg.g);
+	}
+public: // PropertyGraph, read-only
+	decltype(auto) operator[](VertexDescriptor v) const requires (!std::is_void_v<VertexProp>) {
+		return (*g)[v];
+	}
+
+	decltype(auto) operator[](EdgeDescriptor e) const requires (!std::is_void_v<EdgeProp>) {
+		return (*g)[e];
+	}
+};
+
+/**
+ * @brief Creates a ReverseGraph view of `g`, which must outlive the view.
+ */
+template<typename Graph>
+ReverseGraph<Graph> reverseGraph(const Graph &g) {
+	return ReverseGraph<Graph>(g);
+}
+
+} // namespace graph
+
+#endif // GRAPH_REVERSE_GRAPH_HPP
@@ -0,0 +1,150 @@
+#ifndef GRAPH_SIMPLIFY_HPP
+#define GRAPH_SIMPLIFY_HPP
+
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "properties.hpp"
+#include "traits.hpp"
+
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Selects which edges simplify() and loadDimacs() drop.
+ */
+struct SimplifyOptions {
+	// keep only the first added edge of every (src, tar) pair
+	bool removeParallelEdges = true;
+	// drop edges with src == tar
+	bool removeSelfLoops = true;
+};
+
+namespace detail {
+
+/**
+ * @brief LSD radix sort of edge positions by (src, tar): a stable counting sort by target
+ * 			followed by a stable counting sort by source. Edges with the same endpoints keep
+ * 			their relative order, so the first of a group is the first added edge.
+ * @param positions edge positions to sort
+ * @param n number of vertices, bounding the keys
+ * @param src function returning the source index of a position
+ * @param tar function returning the target index of a position
+ */
+template<typename SrcFn, typename TarFn>
+std::vector<std::size_t> sortBySourceTarget(const std::vector<std::size_t> &positions, std::size_t n,
+                                            SrcFn src, TarFn tar) {
+	auto byTarget = countingSort(positions, n, tar);
+	return countingSort(byTarget, n, src);
+}
+
+/**
+ * @brief Sorts a list of (src, tar) pairs with sortBySourceTarget() and filters it according to `opts`.
+ */
+inline std::vector<std::pair<std::size_t, std::size_t>>
+simplifyPairs(const std::vector<std::pair<std::size_t, std::size_t>> &pairs, std::size_t n,
+              SimplifyOptions opts) {
+	std::vector<std::size_t> positions(pairs.size());
+	std::iota(positions.begin(), positions.end(), 0);
+	positions = sortBySourceTarget(positions, n,
+		[&](std::size_t i) { return pairs[i].first; },
+		[&](std::size_t i) { return pairs[i].second; });
+	std::vector<std::pair<std::size_t, std::size_t>> res;
+	res.reserve(pairs.size());
+	for(auto i : positions) {
+		if(opts.removeSelfLoops && pairs[i].first == pairs[i].second) continue;
+		if(opts.removeParallelEdges && !res.empty() && res.back() == pairs[i]) continue;
+		res.push_back(pairs[i]);
+	}
+	return res;
+}
+
+/**
+ * @brief Copies the vertex properties of `g` into `out`, which has the same vertices.
+ */
+template<typename Graph, typename OutGraph>
+void copyVertexProps(const Graph &g, OutGraph &out) {
+	if constexpr(hasVertexProp<Graph>) {
+		for(auto v : vertices(g)) out[v] = g[v];
+	}
+}
+
+} // namespace detail
+
+/**
+ * @brief Builds a copy of `g` without parallel edges and self-loops (as selected by `opts`).
+ * 			The edges are radix sorted by (src, tar) in parallel, so the edges of the result
+ * 			are ordered by source and then by target.
+ * 			Of a group of parallel edges the property of the first added edge is kept,
+ * 			and the properties of the others are folded into it with `reduce(acc, other)`.
+ * @tparam Graph graph type with a constructor taking the number of vertices and addEdges(), e.g. AdjacencyList
+ * @param g graph to simplify
+ * @param reduce callable as `reduce(EdgeProp &acc, const EdgeProp &other)`
+ * @param opts which edges to remove
+ * @return the simplified graph, with the same vertices and vertex properties as `g`.
+ */
+template<typename Graph, typename Reducer>
+Graph simplify(const Graph &g, Reducer reduce, SimplifyOptions opts = {}) {
+	GRAPH_PHASE("simplify");
+	using Edge = typename Traits<Graph>::EdgeDescriptor;
+	const std::size_t n = numVertices(g);
+
+	std::vector<Edge> es;
+	es.reserve(numEdges(g));
+	for(auto e : edges(g)) {
+		if(opts.removeSelfLoops && source(e, g) == target(e, g)) continue;
+		es.push_back(e);
+	}
+	std::vector<std::size_t> positions(es.size());
+	std::iota(positions.begin(), positions.end(), 0);
+	positions = detail::sortBySourceTarget(positions, n,
+		[&](std::size_t i) { return getIndex(source(es[i], g), g); },
+		[&](std::size_t i) { return getIndex(target(es[i], g), g); });
+
+	auto sameEndpoints = [&](const Edge &a, const Edge &b) {
+		return source(a, g) == source(b, g) && target(a, g) == target(b, g);
+	};
+
+	Graph res(n);
+	detail::copyVertexProps(g, res);
+	if constexpr(detail::hasEdgeProp<Graph>) {
+		using EdgeProp = typename Traits<Graph>::EdgeProp;
+		using Vertex = typename Traits<Graph>::VertexDescriptor;
+		std::vector<std::tuple<Vertex, Vertex, EdgeProp>> kept;
+		kept.reserve(es.size());
+		for(std::size_t i = 0; i < positions.size(); ++i) {
+			const Edge &e = es[positions[i]];
+			if(opts.removeParallelEdges && i > 0 && sameEndpoints(es[positions[i - 1]], e))
+				reduce(std::get<2>(kept.back()), g[e]);
+			else
+				kept.emplace_back(source(e, g), target(e, g), g[e]);
+		}
+		addEdges(kept, res);
+	} else {
+		using Vertex = typename Traits<Graph>::VertexDescriptor;
+		std::vector<std::pair<Vertex, Vertex>> kept;
+		kept.reserve(es.size());
+		for(std::size_t i = 0; i < positions.size(); ++i) {
+			const Edge &e = es[positions[i]];
+			if(opts.removeParallelEdges && i > 0 && sameEndpoints(es[positions[i - 1]], e)) continue;
+			kept.emplace_back(source(e, g), target(e, g));
+		}
+		addEdges(kept, res);
+	}
+	return res;
+}
+
+/**
+ * @brief See above, keeping the property of the first added edge of a group of parallel edges.
+ */
+template<typename Graph>
+Graph simplify(const Graph &g, SimplifyOptions opts = {}) {
+	return simplify(g, [](auto &&...) {}, opts);
+}
+
+} // namespace graph
+
+#endif // GRAPH_SIMPLIFY_HPP
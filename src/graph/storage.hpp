@@ -0,0 +1,46 @@
+#ifndef GRAPH_STORAGE_HPP
+#define GRAPH_STORAGE_HPP
+
+#include <boost/container/small_vector.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace graph {
+
+// Storage policies for the per-vertex edge lists of AdjacencyList. A policy provides `List<T, Alloc>`,
+// a sequence container of `T` using the allocator `Alloc`, and `heapCapacity(list)`, the bytes the
+// list allocated outside the stored vertex.
+
+// Every edge list is a std::vector, the default.
+struct VectorStorage {
+	template<typename T, typename Alloc>
+	using List = std::vector<T, Alloc>;
+
+	// Bytes of the heap block of `list`.
+	template<typename L>
+	static std::size_t heapCapacity(const L &list) {
+		return list.capacity() * sizeof(typename L::value_type);
+	}
+};
+
+/**
+ * @brief Every edge list stores up to `N` edges inline in the stored vertex and only allocates from
+ * 			the graph's allocator once a vertex has more, so the many low-degree vertices of a sparse
+ * 			graph need no heap block of their own and their edges sit next to the vertex.
+ */
+template<std::size_t N>
+struct SmallStorage {
+	template<typename T, typename Alloc>
+	using List = boost::container::small_vector<T, N, Alloc>;
+
+	// Bytes of the heap block of `list`, zero while its edges fit inline.
+	template<typename L>
+	static std::size_t heapCapacity(const L &list) {
+		return list.capacity() > N ? list.capacity() * sizeof(typename L::value_type) : 0;
+	}
+};
+
+} // namespace graph
+
+#endif // GRAPH_STORAGE_HPP
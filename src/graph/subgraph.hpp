@@ -0,0 +1,237 @@
+#ifndef GRAPH_SUBGRAPH_HPP
+#define GRAPH_SUBGRAPH_HPP
+
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "property_map.hpp"
+#include "transpose.hpp"
+#include "traits.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Result of inducedSubgraph(): the subgraph with compact vertex numbering
+ * 			and the map from its vertices back to the vertices of the original graph.
+ */
+template<typename Graph>
+struct Subgraph {
+	using VertexDescriptor = typename Traits<Graph>::VertexDescriptor;
+
+	Graph graph;
+	// toOriginal[getIndex(v, graph)] is the vertex of the original graph that v was copied from
+	std::vector<VertexDescriptor> toOriginal;
+};
+
+/**
+ * @brief Copies the vertices of `vertexSet` and the edges between them into a new graph.
+ * 			The i'th distinct vertex of `vertexSet` becomes vertex i of the subgraph,
+ * 			vertex and edge properties are copied along. The map from old to new vertex indices
+ * 			is caller provided, so with a GenerationPropertyMap that is cleared between calls,
+ * 			extracting many small subgraphs of a big graph costs O(subgraph) each instead of O(V).
+ * @tparam Graph graph type with a constructor taking the number of vertices and addEdges(), e.g. AdjacencyList
+ * @param g the graph to extract from
+ * @param vertexSet range of vertex descriptors of `g`, duplicates are ignored
+ * @param toNew map with a key for every vertex index, every key must read as
+ * 			std::numeric_limits<std::size_t>::max(); holds the new index of the copied vertices afterwards.
+ * @return the subgraph and the map back to the vertices of `g`.
+ */
+template<typename Graph, typename VertexSet, ReadWritePropertyMap<std::size_t> IndexMap>
+Subgraph<Graph> inducedSubgraph(const Graph &g, const VertexSet &vertexSet, IndexMap &toNew) {
+	GRAPH_PHASE("inducedSubgraph");
+	constexpr std::size_t absent = std::numeric_limits<std::size_t>::max();
+	std::vector<typename Traits<Graph>::VertexDescriptor> toOriginal;
+	for(auto v : vertexSet) {
+		if(get(toNew, getIndex(v, g)) != absent) continue;
+		put(toNew, getIndex(v, g), toOriginal.size());
+		toOriginal.push_back(v);
+	}
+
+	std::vector<detail::EdgeTuple<Graph>> es;
+	for(auto v : toOriginal) {
+		const std::size_t src = get(toNew, getIndex(v, g));
+		for(auto e : outEdges(v, g)) {
+			const std::size_t tar = get(toNew, getIndex(target(e, g), g));
+			if(tar != absent) es.push_back(detail::makeEdgeTuple(src, tar, e, g));
+		}
+	}
+
+	Subgraph<Graph> res{Graph(toOriginal.size()), std::move(toOriginal)};
+	if constexpr(detail::hasVertexProp<Graph>) {
+		for(std::size_t i = 0; i < res.toOriginal.size(); ++i) res.graph[i] = g[res.toOriginal[i]];
+	}
+	addEdges(es, res.graph);
+	return res;
+}
+
+/**
+ * @brief See above, with an O(V) index map of its own.
+ */
+template<typename Graph, typename VertexSet>
+Subgraph<Graph> inducedSubgraph(const Graph &g, const VertexSet &vertexSet) {
+	VectorPropertyMap<std::size_t> toNew(numVertices(g), std::numeric_limits<std::size_t>::max());
+	return inducedSubgraph(g, vertexSet, toNew);
+}
+
+/**
+ * @brief Ego networks extracted by egoNetworks(), all stored in one set of flat arrays.
+ * 			Ego network i owns the vertices [vertexOffsets[i], vertexOffsets[i + 1]) of `vertices`,
+ * 			and is a CSR graph: the neighbours of its local vertex j (global position p = vertexOffsets[i] + j)
+ * 			are targets[rowOffsets[p]] through targets[rowOffsets[p + 1] - 1], as local vertex numbers.
+ */
+template<typename VertexDescriptor>
+struct EgoNetworks {
+	/**
+	 * @brief Lightweight view of a single ego network.
+	 */
+	struct EgoNetwork {
+		// Number of vertices in the ego network, the seed is local vertex 0.
+		std::size_t numVertices() const { return vertices.size(); }
+
+		// The vertex of the original graph that local vertex `j` stands for.
+		VertexDescriptor original(std::size_t j) const { return vertices[j]; }
+
+		// Local numbers of the out neighbours of local vertex `j`.
+		std::span<const std::uint32_t> neighbours(std::size_t j) const {
+			return std::span<const std::uint32_t>(targets + rowOffsets[j], targets + rowOffsets[j + 1]);
+		}
+
+		std::span<const VertexDescriptor> vertices;
+		const std::size_t *rowOffsets;
+		const std::uint32_t *targets;
+	};
+public:
+	// Number of ego networks, one per seed.
+	std::size_t size() const { return vertexOffsets.size() - 1; }
+
+	EgoNetwork operator[](std::size_t i) const {
+		const std::size_t first = vertexOffsets[i], last = vertexOffsets[i + 1];
+		return EgoNetwork{std::span<const VertexDescriptor>(vertices.data() + first, last - first),
+		                  rowOffsets.data() + first, targets.data()};
+	}
+public:
+	std::vector<std::size_t> vertexOffsets;
+	std::vector<VertexDescriptor> vertices;
+	std::vector<std::size_t> rowOffsets;
+	std::vector<std::uint32_t> targets;
+};
+
+/**
+ * @brief Per-thread scratch state of egoNetworks(): for every chunk of seeds, the local number of
+ * 			every vertex in the current ego network, cleared in O(1) per seed. Keep one and pass it to
+ * 			repeated calls to reuse the O(V) maps instead of allocating them per call.
+ */
+using EgoScratch = std::vector<GenerationPropertyMap<std::uint32_t>>;
+
+/**
+ * @brief Extracts the k-hop out-neighbourhood of every seed together with the edges between
+ * 			its vertices. Seeds are processed in parallel; each thread appends its ego networks to
+ * 			its own buffers, which are then copied into the shared flat arrays, so no allocation
+ * 			is made per ego network. Vertices of an ego network are in BFS order from the seed.
+ * 			Use symmetrize() first for neighbourhoods that ignore edge direction.
+ * @param g the graph to extract from
+ * @param seeds range of vertex descriptors of `g`
+ * @param k number of hops
+ * @param scratch per-thread maps, (re)created as needed for numVertices(g) and the number of threads
+ * @return one ego network per seed, in the order of `seeds`.
+ */
+template<typename Graph, typename Seeds>
+EgoNetworks<typename Traits<Graph>::VertexDescriptor>
+egoNetworks(const Graph &g, const Seeds &seeds, std::size_t k, EgoScratch &scratch) {
+	GRAPH_PHASE("egoNetworks");
+	using Vertex = typename Traits<Graph>::VertexDescriptor;
+	struct Buffer {
+		std::vector<std::size_t> vertexOffsets;
+		std::vector<Vertex> vertices;
+		std::vector<std::size_t> rowOffsets;
+		std::vector<std::uint32_t> targets;
+	};
+
+	// the local number of a vertex outside the current ego network
+	constexpr std::uint32_t absent = std::numeric_limits<std::uint32_t>::max();
+
+	const std::vector<Vertex> seedVec(seeds.begin(), seeds.end());
+	const std::size_t chunks = detail::numChunks(seedVec.size());
+	std::vector<Buffer> buffers(chunks);
+	if(scratch.size() < chunks) scratch.resize(chunks);
+	for(std::size_t c = 0; c < chunks; ++c) {
+		if(scratch[c].size() != numVertices(g))
+			scratch[c] = GenerationPropertyMap<std::uint32_t>(numVertices(g), absent);
+	}
+
+	detail::parallelChunks(seedVec.size(), [&](std::size_t c, std::size_t first, std::size_t last) {
+		Buffer &buf = buffers[c];
+		GenerationPropertyMap<std::uint32_t> &localId = scratch[c];
+		std::vector<std::size_t> depth;
+		for(std::size_t s = first; s != last; ++s) {
+			localId.clear();
+			const std::size_t base = buf.vertices.size();
+			buf.vertexOffsets.push_back(base);
+			depth.clear();
+
+			auto discover = [&](Vertex v, std::size_t d) {
+				const auto idx = getIndex(v, g);
+				if(get(localId, idx) != absent) return;
+				put(localId, idx, static_cast<std::uint32_t>(buf.vertices.size() - base));
+				buf.vertices.push_back(v);
+				depth.push_back(d);
+			};
+			discover(seedVec[s], 0);
+			for(std::size_t j = 0; base + j < buf.vertices.size(); ++j) {
+				if(depth[j] == k) continue;
+				for(auto e : outEdges(buf.vertices[base + j], g)) discover(target(e, g), depth[j] + 1);
+			}
+
+			for(std::size_t j = base; j < buf.vertices.size(); ++j) {
+				buf.rowOffsets.push_back(buf.targets.size());
+				for(auto e : outEdges(buf.vertices[j], g)) {
+					const std::uint32_t local = get(localId, getIndex(target(e, g), g));
+					if(local != absent) buf.targets.push_back(local);
+				}
+			}
+		}
+	});
+
+	std::vector<std::size_t> vertexBase(chunks + 1, 0), targetBase(chunks + 1, 0);
+	for(std::size_t c = 0; c < chunks; ++c) {
+		vertexBase[c + 1] = vertexBase[c] + buffers[c].vertices.size();
+		targetBase[c + 1] = targetBase[c] + buffers[c].targets.size();
+	}
+
+	EgoNetworks<Vertex> res;
+	res.vertexOffsets.resize(seedVec.size() + 1);
+	res.vertices.resize(vertexBase[chunks]);
+	res.rowOffsets.resize(vertexBase[chunks] + 1);
+	res.targets.resize(targetBase[chunks]);
+	detail::parallelChunks(seedVec.size(), [&](std::size_t c, std::size_t first, std::size_t) {
+		const Buffer &buf = buffers[c];
+		for(std::size_t i = 0; i < buf.vertexOffsets.size(); ++i)
+			res.vertexOffsets[first + i] = vertexBase[c] + buf.vertexOffsets[i];
+		std::copy(buf.vertices.begin(), buf.vertices.end(), res.vertices.begin() + vertexBase[c]);
+		for(std::size_t j = 0; j < buf.rowOffsets.size(); ++j)
+			res.rowOffsets[vertexBase[c] + j] = targetBase[c] + buf.rowOffsets[j];
+		std::copy(buf.targets.begin(), buf.targets.end(), res.targets.begin() + targetBase[c]);
+	});
+	res.vertexOffsets.back() = vertexBase[chunks];
+	res.rowOffsets.back() = targetBase[chunks];
+	return res;
+}
+
+/**
+ * @brief See above, with scratch maps of its own.
+ */
+template<typename Graph, typename Seeds>
+EgoNetworks<typename Traits<Graph>::VertexDescriptor>
+egoNetworks(const Graph &g, const Seeds &seeds, std::size_t k) {
+	EgoScratch scratch;
+	return egoNetworks(g, seeds, k, scratch);
+}
+
+} // namespace graph
+
+#endif // GRAPH_SUBGRAPH_HPP
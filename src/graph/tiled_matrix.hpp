@@ -0,0 +1,407 @@
+#ifndef GRAPH_TILED_MATRIX_HPP
+#define GRAPH_TILED_MATRIX_HPP
+
+#include "concepts.hpp"
+#include "instrumentation.hpp"
+#include "memory_usage.hpp"
+#include "tags.hpp"
+#include "traits.hpp"
+
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/iterator_facade.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <ranges>
+#include <tuple>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief Directed graph storing the adjacency matrix as 64x64 bit tiles, keeping only the
+ * 			tiles holding at least one edge. Vertices are grouped in blocks of 64, and every
+ * 			row block has a directory of its non-empty tiles sorted by column block.
+ * 			Memory is O(n / 64 + tiles * 512 bytes), in between AdjacencyMatrix and AdjacencyList
+ * 			for graphs whose edges cluster, and edge scans read whole words instead of chasing
+ * 			one pointer per edge. Parallel edges are collapsed, as a cell holds one bit.
+ * 			bfsLevels() and transitiveClosure() work on whole tiles at a time.
+ */
+struct TiledMatrix {
+private:
+	using Word = std::uint64_t;
+	static constexpr std::size_t tileBits = 64;
+	// word r holds the bits of row r of the tile, bit c is the edge to column c
+	using Tile = std::array<Word, tileBits>;
+
+	struct TileEntry {
+		std::size_t colBlock;
+		std::size_t tile; // index into tiles
+	};
+	using Directory = std::vector<TileEntry>;
+public: // Graph
+	using VertexDescriptor = std::size_t;
+
+	struct EdgeDescriptor {
+		std::size_t src, tar;
+	public:
+		friend bool operator==(const EdgeDescriptor &a, const EdgeDescriptor &b) {
+			return std::tie(a.src, a.tar) == std::tie(b.src, b.tar);
+		}
+	};
+
+	using DirectedCategory = tags::Directed;
+
+	// level of the vertices bfsLevels() does not reach
+	static constexpr std::size_t unreachable = std::numeric_limits<std::size_t>::max();
+public: // VertexListGraph
+	struct VertexRange {
+		using iterator = boost::counting_iterator<VertexDescriptor>;
+	public:
+		VertexRange(std::size_t n) : n(n) {}
+		iterator begin() const { return iterator(0); }
+		iterator end()   const { return iterator(n); }
+	private:
+		std::size_t n;
+	};
+public: // IncidenceGraph
+	struct OutEdgeRange {
+		// Visits the row of src in each tile of its row block, in column block order,
+		// so the out edges come in increasing target order.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor, std::forward_iterator_tag, EdgeDescriptor> {
+			iterator() = default;
+			iterator(const TiledMatrix *g, const TileEntry *entry, const TileEntry *last, std::size_t src)
+				: g(g), entry(entry), last(last), src(src) {
+				if(entry != last) {
+					cur = g->tileRow(*entry, src);
+					skipEmpty();
+				}
+			}
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const {
+				return EdgeDescriptor{src, entry->colBlock * tileBits + std::countr_zero(cur)};
+			}
+
+			bool equal(const iterator &other) const {
+				return entry == other.entry && cur == other.cur;
+			}
+
+			void increment() {
+				cur &= cur - 1; // clear the lowest set bit
+				skipEmpty();
+			}
+
+			void skipEmpty() {
+				while(cur == 0 && ++entry != last) cur = g->tileRow(*entry, src);
+			}
+		private:
+			const TiledMatrix *g = nullptr;
+			const TileEntry *entry = nullptr, *last = nullptr;
+			std::size_t src = 0;
+			Word cur = 0;
+		};
+	public:
+		OutEdgeRange(VertexDescriptor v, const TiledMatrix &g) : v(v), g(&g) {}
+
+		iterator begin() const {
+			const Directory &d = g->dirs[v / tileBits];
+			return iterator(g, d.data(), d.data() + d.size(), v);
+		}
+
+		iterator end() const {
+			const Directory &d = g->dirs[v / tileBits];
+			return iterator(g, d.data() + d.size(), d.data() + d.size(), v);
+		}
+	private:
+		VertexDescriptor v;
+		const TiledMatrix *g;
+	};
+public: // EdgeListGraph
+	struct EdgeRange {
+		// Walks the vertices in order and scans the out edges of each.
+		struct iterator : boost::iterator_facade<
+				iterator, EdgeDescriptor, std::forward_iterator_tag, EdgeDescriptor> {
+			iterator() = default;
+			iterator(const TiledMatrix *g, std::size_t src) : g(g), src(src) { skipEmptyVertices(); }
+		private:
+			friend class boost::iterator_core_access;
+
+			EdgeDescriptor dereference() const { return *it; }
+
+			bool equal(const iterator &other) const {
+				return src == other.src && (src == g->n || it == other.it);
+			}
+
+			void increment() {
+				if(++it == outEdges(src, *g).end()) {
+					++src;
+					skipEmptyVertices();
+				}
+			}
+
+			void skipEmptyVertices() {
+				for(; src != g->n; ++src) {
+					it = outEdges(src, *g).begin();
+					if(it != outEdges(src, *g).end()) return;
+				}
+			}
+		private:
+			const TiledMatrix *g = nullptr;
+			std::size_t src = 0;
+			OutEdgeRange::iterator it;
+		};
+	public:
+		EdgeRange(const TiledMatrix &g) : g(&g) {}
+		iterator begin() const { return iterator(g, 0); }
+		iterator end()   const { return iterator(g, g->n); }
+	private:
+		const TiledMatrix *g;
+	};
+public:
+	explicit TiledMatrix(std::size_t n = 0) : n(n), dirs(numBlocks(n)) {}
+
+	// Copies the edges of `g`, parallel edges are stored once.
+	template<EdgeListGraph Graph>
+	explicit TiledMatrix(const Graph &g) : TiledMatrix(numVertices(g)) {
+		for(auto e : edges(g)) setBit(getIndex(source(e, g), g), getIndex(target(e, g), g));
+	}
+private:
+	static std::size_t numBlocks(std::size_t numVertices) {
+		return (numVertices + tileBits - 1) / tileBits;
+	}
+
+	Word tileRow(const TileEntry &entry, VertexDescriptor src) const {
+		return tiles[entry.tile][src % tileBits];
+	}
+
+	// The tile of (rowBlock, colBlock), or nullptr if it is empty.
+	const Tile *findTile(std::size_t rowBlock, std::size_t colBlock) const {
+		const Directory &d = dirs[rowBlock];
+		auto it = std::lower_bound(d.begin(), d.end(), colBlock,
+			[](const TileEntry &e, std::size_t c) { return e.colBlock < c; });
+		if(it == d.end() || it->colBlock != colBlock) return nullptr;
+		return &tiles[it->tile];
+	}
+
+	// The tile of (rowBlock, colBlock), inserted into the directory if it was empty.
+	Tile &tileAt(std::size_t rowBlock, std::size_t colBlock) {
+		Directory &d = dirs[rowBlock];
+		auto it = std::lower_bound(d.begin(), d.end(), colBlock,
+			[](const TileEntry &e, std::size_t c) { return e.colBlock < c; });
+		if(it == d.end() || it->colBlock != colBlock) {
+			it = d.insert(it, TileEntry{colBlock, tiles.size()});
+			tiles.emplace_back();
+		}
+		return tiles[it->tile];
+	}
+
+	// Sets the bit of (src, tar) and returns whether it was clear before.
+	bool setBit(VertexDescriptor src, VertexDescriptor tar) {
+		Word &w = tileAt(src / tileBits, tar / tileBits)[src % tileBits];
+		const Word bit = Word(1) << (tar % tileBits);
+		if(w & bit) return false;
+		w |= bit;
+		++m;
+		return true;
+	}
+
+	// C |= A * B over the boolean semiring, one row of A selects the rows of B to merge.
+	static void multiplyInto(const Tile &a, const Tile &b, Tile &c) {
+		for(std::size_t r = 0; r < tileBits; ++r)
+			for(Word w = a[r]; w; w &= w - 1) c[r] |= b[std::countr_zero(w)];
+	}
+
+	// Recounts m from the tiles after they were written directly.
+	void recount() {
+		m = 0;
+		for(const Tile &t : tiles)
+			for(Word w : t) m += std::popcount(w);
+	}
+private:
+	std::size_t n;
+	std::size_t m = 0;
+	// one directory per row block, sorted by column block
+	std::vector<Directory> dirs;
+	std::vector<Tile> tiles;
+public: // Graph
+	friend VertexDescriptor source(const EdgeDescriptor &e, const TiledMatrix &) {
+		return e.src;
+	}
+
+	friend VertexDescriptor target(const EdgeDescriptor &e, const TiledMatrix &) {
+		return e.tar;
+	}
+public: // VertexListGraph
+	friend std::size_t numVertices(const TiledMatrix &g) {
+		return g.n;
+	}
+
+	friend VertexRange vertices(const TiledMatrix &g) {
+		return VertexRange(g.n);
+	}
+public: // EdgeListGraph
+	friend std::size_t numEdges(const TiledMatrix &g) {
+		return g.m;
+	}
+
+	friend EdgeRange edges(const TiledMatrix &g) {
+		return EdgeRange(g);
+	}
+public: // IncidenceGraph
+	friend OutEdgeRange outEdges(VertexDescriptor v, const TiledMatrix &g) {
+		return OutEdgeRange(v, g);
+	}
+
+	friend std::size_t outDegree(VertexDescriptor v, const TiledMatrix &g) {
+		std::size_t degree = 0;
+		for(const TileEntry &e : g.dirs[v / tileBits]) degree += std::popcount(g.tileRow(e, v));
+		return degree;
+	}
+
+	// Binary search over the directory of the row block of src, then one bit test.
+	friend std::optional<EdgeDescriptor> edge(VertexDescriptor src, VertexDescriptor tar, const TiledMatrix &g) {
+		const Tile *t = g.findTile(src / tileBits, tar / tileBits);
+		if(!t || !(((*t)[src % tileBits] >> (tar % tileBits)) & 1)) return std::nullopt;
+		return EdgeDescriptor{src, tar};
+	}
+public: // Mutable
+	friend VertexDescriptor addVertex(TiledMatrix &g) {
+		if(g.n % tileBits == 0) g.dirs.emplace_back();
+		return g.n++;
+	}
+
+	// Adds the edge from src to tar, which is a no-op if it already exists.
+	friend EdgeDescriptor addEdge(VertexDescriptor src, VertexDescriptor tar, TiledMatrix &g) {
+		g.setBit(src, tar);
+		return EdgeDescriptor{src, tar};
+	}
+
+	/**
+	 * @brief Bulk version of addEdge, edges that already exist are skipped.
+	 * @param es forward range of std::pair(src, tar)
+	 */
+	template<std::ranges::forward_range EdgePairRange>
+	friend void addEdges(const EdgePairRange &es, TiledMatrix &g) {
+		GRAPH_PHASE("addEdges");
+		for(const auto &x : es) g.setBit(std::get<0>(x), std::get<1>(x));
+	}
+public: // Tile-level algorithms
+	/**
+	 * @brief Breadth-first search from `s` moving whole tiles at a time: the frontier is a
+	 * 			bitmap with one word per vertex block, and every non-empty tile (i, j) merges the rows
+	 * 			of the frontier vertices in block i into word j of the next frontier.
+	 *
+	 * @return the number of edges on a shortest path from `s` to each vertex, or unreachable
+	 */
+	friend std::vector<std::size_t> bfsLevels(const TiledMatrix &g, VertexDescriptor s) {
+		GRAPH_PHASE("bfsLevels");
+		const std::size_t blocks = g.dirs.size();
+		std::vector<std::size_t> level(g.n, unreachable);
+		std::vector<Word> frontier(blocks), next(blocks), visited(blocks);
+		frontier[s / tileBits] = visited[s / tileBits] = Word(1) << (s % tileBits);
+		level[s] = 0;
+		for(std::size_t depth = 1;; ++depth) {
+			bool any = false;
+			std::fill(next.begin(), next.end(), Word(0));
+			for(std::size_t i = 0; i < blocks; ++i) {
+				if(!frontier[i]) continue;
+				for(const TileEntry &e : g.dirs[i]) {
+					const Tile &t = g.tiles[e.tile];
+					Word merged = 0;
+					for(Word w = frontier[i]; w; w &= w - 1) merged |= t[std::countr_zero(w)];
+					next[e.colBlock] |= merged;
+				}
+			}
+			for(std::size_t j = 0; j < blocks; ++j) {
+				next[j] &= ~visited[j];
+				visited[j] |= next[j];
+				for(Word w = next[j]; w; w &= w - 1) level[j * tileBits + std::countr_zero(w)] = depth;
+				any |= next[j] != 0;
+			}
+			if(!any) return level;
+			frontier.swap(next);
+		}
+	}
+
+	/**
+	 * @brief Transitive closure by repeated squaring R = R | R * R over the tiles, where a tile
+	 * 			product is the boolean product of two 64x64 bit matrices. Terminates after
+	 * 			O(log(longest shortest path)) rounds, each touching only non-empty tiles.
+	 *
+	 * @return graph with an edge (u, v) iff v is reachable from u by a path of at least one edge
+	 */
+	friend TiledMatrix transitiveClosure(const TiledMatrix &g) {
+		GRAPH_PHASE("transitiveClosure");
+		const std::size_t blocks = g.dirs.size();
+		TiledMatrix r = g;
+		constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+		std::vector<std::size_t> slot(blocks);
+		for(;;) {
+			TiledMatrix next(r.n);
+			for(std::size_t i = 0; i < blocks; ++i) {
+				// gather row block i of R | R * R in a dense map from column block to tile
+				std::fill(slot.begin(), slot.end(), none);
+				std::vector<Tile> acc;
+				std::vector<std::size_t> cols;
+				auto accumulate = [&](std::size_t j) -> Tile& {
+					if(slot[j] == none) {
+						slot[j] = acc.size();
+						acc.emplace_back();
+						cols.push_back(j);
+					}
+					return acc[slot[j]];
+				};
+				for(const TileEntry &ik : r.dirs[i]) {
+					const Tile &a = r.tiles[ik.tile];
+					Tile &own = accumulate(ik.colBlock);
+					for(std::size_t row = 0; row < tileBits; ++row) own[row] |= a[row];
+					for(const TileEntry &kj : r.dirs[ik.colBlock])
+						multiplyInto(a, r.tiles[kj.tile], accumulate(kj.colBlock));
+				}
+				std::sort(cols.begin(), cols.end());
+				for(std::size_t j : cols) {
+					next.dirs[i].push_back(TileEntry{j, next.tiles.size()});
+					next.tiles.push_back(acc[slot[j]]);
+				}
+			}
+			next.recount();
+			if(next.m == r.m) return next;
+			r = std::move(next);
+		}
+	}
+public: // Memory
+	// The tiles are the edge array, the directories the adjacency entries.
+	friend MemoryUsage memoryUsage(const TiledMatrix &g) {
+		MemoryUsage usage;
+		usage.vertexArray = detail::usedBytes(g.dirs);
+		usage.edgeArray = detail::usedBytes(g.tiles);
+		usage.slack = detail::slackBytes(g.dirs) + detail::slackBytes(g.tiles);
+		for(const Directory &d : g.dirs) {
+			usage.adjacencySize += detail::usedBytes(d);
+			usage.adjacencyCapacity += d.capacity() * sizeof(TileEntry);
+			usage.slack += detail::slackBytes(d);
+		}
+		return usage;
+	}
+
+	friend void shrinkToFit(TiledMatrix &g) {
+		g.dirs.shrink_to_fit();
+		g.tiles.shrink_to_fit();
+		for(Directory &d : g.dirs) d.shrink_to_fit();
+	}
+public: // Other
+	friend std::size_t getIndex(VertexDescriptor v, const TiledMatrix &) {
+		return v;
+	}
+};
+
+} // namespace graph
+
+#endif // GRAPH_TILED_MATRIX_HPP
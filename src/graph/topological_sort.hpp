@@ -2,12 +2,13 @@
 #define GRAPH_TOPOLOGICAL_SORT_HPP
 
 #include "depth_first_search.hpp"
+#include "instrumentation.hpp"
 
 namespace graph {
-namespace detail {
 
 /**
- * @brief Derived from the DFSNullVisitor class.
+ * @brief Derived from the DFSNullVisitor class. Public so it can be combined with other visitors,
+ * 			e.g. dfs(g, composeVisitors(StatsVisitor(stats), TopoVisitor(out))).
  * @tparam OIter output iterator to write to when a vertex's visit is finished.
  */
 template<typename OIter>
@@ -30,8 +31,6 @@ private:
 	OIter iter;
 };
 
-} // namespace detail
-
 /**
  * @brief Runs dfs on a graph using the TopoVisitor class and
  * 			uses the output iterator to save the reverse order of the sort.
@@ -42,7 +41,37 @@ private:
  */
 template<typename Graph, typename OutputIterator>
 void topoSort(const Graph &g, OutputIterator oIter) {
-	dfs(g, graph::detail::TopoVisitor (oIter));
+	GRAPH_PHASE("topoSort");
+	dfs(g, TopoVisitor(oIter));
+}
+
+/**
+ * @brief Same as topoSort(g, oIter) but keeps the dfs colours in a caller provided property map,
+ * 			so repeated sorts can reuse the buffer.
+ * @tparam ColourMap property map from vertex index to DFSColour
+ * @param g graph to run the sort on.
+ * @param oIter output iterator to save the reverse result in.
+ * @param colour map with a key for every vertex index.
+ */
+template<typename Graph, typename OutputIterator, ReadWritePropertyMap<DFSColour> ColourMap>
+void topoSort(const Graph &g, OutputIterator oIter, ColourMap &colour) {
+	GRAPH_PHASE("topoSort");
+	dfs(g, TopoVisitor(oIter), colour);
+}
+
+/**
+ * @brief Topological sort of the vertices reachable from `start`, see dfsFrom().
+ * 			Vertices already coloured by an earlier call with the same map are skipped,
+ * 			so calling it for several starts without clearing the map sorts their union.
+ * @param g graph to run the sort on.
+ * @param start vertex to start from.
+ * @param oIter output iterator to save the reverse result in.
+ * @param colour map where every unvisited vertex reads as White.
+ */
+template<typename Graph, typename OutputIterator, ReadWritePropertyMap<DFSColour> ColourMap>
+void topoSortFrom(const Graph &g, typename Traits<Graph>::VertexDescriptor start, OutputIterator oIter, ColourMap &colour) {
+	GRAPH_PHASE("topoSortFrom");
+	dfsFrom(g, start, TopoVisitor(oIter), colour);
 }
 
 } // namespace graph
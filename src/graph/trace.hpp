@@ -0,0 +1,237 @@
+#ifndef GRAPH_TRACE_HPP
+#define GRAPH_TRACE_HPP
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace graph {
+
+/**
+ * @brief One begin or end event of a traced scope, as read back from a TraceBuffer.
+ */
+struct TraceEvent {
+	const char *name = nullptr;
+	std::uint64_t nanoseconds = 0; // since traceEpoch()
+	bool begin = false;
+};
+
+/**
+ * @return the time the trace timestamps count from, fixed at the first call.
+ */
+inline std::chrono::steady_clock::time_point traceEpoch() {
+	static const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+	return epoch;
+}
+
+/**
+ * @brief Ring buffer of the trace events of one thread. Only the owning thread writes, without locks,
+ * 			in the manner of a seqlock: it announces a record by bumping the start count, then fills the
+ * 			slot and publishes it by bumping the write count. Once full, the oldest events are
+ * 			overwritten. Readers copy the published events, then drop every slot a record started
+ * 			since may have touched, so reading never blocks the traced thread and never returns a
+ * 			torn or out of order event.
+ */
+class TraceBuffer {
+public:
+	static constexpr std::size_t capacity = std::size_t(1) << 16;
+
+	explicit TraceBuffer(std::size_t threadId) : threadId(threadId), slots(new Slot[capacity]) {}
+
+	std::size_t id() const { return threadId; }
+
+	// Called by the owning thread only.
+	void record(const char *name, bool begin) {
+		const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - traceEpoch()).count();
+		const std::uint64_t i = written.load(std::memory_order_relaxed);
+		started.store(i + 1, std::memory_order_relaxed);
+		// orders the announcement before the slot stores, pairs with the fence in events()
+		std::atomic_thread_fence(std::memory_order_release);
+		Slot &slot = slots[i & (capacity - 1)];
+		slot.name.store(name, std::memory_order_relaxed);
+		slot.stamp.store(static_cast<std::uint64_t>(ns) << 1 | begin, std::memory_order_relaxed);
+		written.store(i + 1, std::memory_order_release);
+	}
+
+	/**
+	 * @return the events still in the buffer and recorded after the last clear(), oldest first.
+	 */
+	std::vector<TraceEvent> events() const {
+		const std::uint64_t end = written.load(std::memory_order_acquire);
+		std::uint64_t first = std::max(cleared.load(std::memory_order_relaxed), end > capacity ? end - capacity : 0);
+		std::vector<TraceEvent> out;
+		out.reserve(end - first);
+		for(std::uint64_t i = first; i < end; ++i) {
+			const Slot &slot = slots[i & (capacity - 1)];
+			const std::uint64_t stamp = slot.stamp.load(std::memory_order_relaxed);
+			out.push_back(TraceEvent{slot.name.load(std::memory_order_relaxed), stamp >> 1, (stamp & 1) != 0});
+		}
+		// record r overwrites slot r - capacity, so slots below started - capacity may have been
+		// rewritten during the copy, including the one a record still in progress is writing
+		std::atomic_thread_fence(std::memory_order_acquire);
+		const std::uint64_t now = started.load(std::memory_order_relaxed);
+		if(now > capacity && now - capacity > first)
+			out.erase(out.begin(), out.begin() + std::min<std::uint64_t>(now - capacity - first, out.size()));
+		return out;
+	}
+
+	// Hides the events recorded so far from events(), the writer is not disturbed.
+	void clear() { cleared.store(written.load(std::memory_order_acquire), std::memory_order_relaxed); }
+private:
+	struct Slot {
+		std::atomic<const char*> name{nullptr};
+		std::atomic<std::uint64_t> stamp{0}; // nanoseconds << 1 | begin
+	};
+
+	std::size_t threadId;
+	std::unique_ptr<Slot[]> slots;
+	// records started and records published, they differ while a record is in progress
+	std::atomic<std::uint64_t> started{0};
+	std::atomic<std::uint64_t> written{0};
+	std::atomic<std::uint64_t> cleared{0};
+};
+
+namespace detail {
+
+/**
+ * @brief All buffers ever created, shared so the events of finished threads can still be written.
+ * 			When a thread exits its buffer is put on an idle list and handed to the next thread that
+ * 			starts tracing, which continues the ring (and the trace thread id) of the finished one.
+ * 			So the registry retains one buffer per thread that ever traced concurrently, however
+ * 			many threads are started over the life of the process.
+ */
+class TraceRegistry {
+public:
+	std::shared_ptr<TraceBuffer> acquire() {
+		std::lock_guard<std::mutex> lock(mutex);
+		if(!idle.empty()) {
+			auto buffer = std::move(idle.back());
+			idle.pop_back();
+			return buffer;
+		}
+		buffers.push_back(std::make_shared<TraceBuffer>(buffers.size()));
+		return buffers.back();
+	}
+
+	void release(std::shared_ptr<TraceBuffer> buffer) {
+		std::lock_guard<std::mutex> lock(mutex);
+		idle.push_back(std::move(buffer));
+	}
+
+	std::vector<std::shared_ptr<TraceBuffer>> snapshot() {
+		std::lock_guard<std::mutex> lock(mutex);
+		return buffers;
+	}
+private:
+	std::mutex mutex;
+	std::vector<std::shared_ptr<TraceBuffer>> buffers;
+	std::vector<std::shared_ptr<TraceBuffer>> idle; // buffers of exited threads
+};
+
+inline TraceRegistry &traceRegistry() {
+	static TraceRegistry registry;
+	return registry;
+}
+
+// Holds the buffer of a thread and returns it to the registry when the thread exits.
+struct ThreadTraceHandle {
+	ThreadTraceHandle() : buffer(traceRegistry().acquire()) {}
+	ThreadTraceHandle(const ThreadTraceHandle&) = delete;
+	ThreadTraceHandle &operator=(const ThreadTraceHandle&) = delete;
+	~ThreadTraceHandle() { traceRegistry().release(std::move(buffer)); }
+
+	std::shared_ptr<TraceBuffer> buffer;
+};
+
+// Buffer of the calling thread, acquired on first use and released on exit; the only locks a
+// traced thread ever takes.
+inline TraceBuffer &threadTraceBuffer() {
+	thread_local ThreadTraceHandle handle;
+	return *handle.buffer;
+}
+
+inline void writeJsonString(std::ostream &s, const char *str) {
+	s << '"';
+	for(; *str; ++str) {
+		if(*str == '"' || *str == '\\') s << '\\';
+		s << *str;
+	}
+	s << '"';
+}
+
+} // namespace detail
+
+/**
+ * @brief Records a begin event for the phase `name` on construction and an end event on destruction
+ * 			in the buffer of the calling thread. `name` must outlive the trace, usually it is a string
+ * 			literal. Usually used through GRAPH_PHASE, see instrumentation.hpp.
+ */
+class ScopedTrace {
+public:
+	explicit ScopedTrace(const char *name) : name(name) { detail::threadTraceBuffer().record(name, true); }
+
+	ScopedTrace(const ScopedTrace&) = delete;
+	ScopedTrace &operator=(const ScopedTrace&) = delete;
+
+	~ScopedTrace() { detail::threadTraceBuffer().record(name, false); }
+private:
+	const char *name;
+};
+
+// Drops the events recorded so far by all threads.
+inline void clearTrace() {
+	for(const auto &buffer : detail::traceRegistry().snapshot()) buffer->clear();
+}
+
+/**
+ * @brief Writes the recorded events of all threads in the Chrome trace event format, to be opened in
+ * 			chrome://tracing or https://ui.perfetto.dev. Threads are numbered in order of their first
+ * 			event; a thread started after another exited may reuse its number. End events whose
+ * 			begin was overwritten in the ring buffer are left out.
+ */
+inline std::ostream &writeChromeTrace(std::ostream &s) {
+	const int pid = static_cast<int>(getpid());
+	const char *separator = "\n";
+	s << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [";
+	for(const auto &buffer : detail::traceRegistry().snapshot()) {
+		std::size_t depth = 0;
+		for(const TraceEvent &e : buffer->events()) {
+			if(!e.begin && depth == 0) continue;
+			depth = e.begin ? depth + 1 : depth - 1;
+			s << separator << "  {\"name\": ";
+			detail::writeJsonString(s, e.name);
+			// timestamps are microseconds, the fraction keeps the nanoseconds
+			s << ", \"cat\": \"graph\", \"ph\": \"" << (e.begin ? 'B' : 'E') << "\", \"ts\": "
+			  << e.nanoseconds / 1000 << '.' << std::to_string(1000 + e.nanoseconds % 1000).substr(1)
+			  << ", \"pid\": " << pid << ", \"tid\": " << buffer->id() << "}";
+			separator = ",\n";
+		}
+	}
+	return s << "\n]}\n";
+}
+
+/**
+ * @brief Writes the trace to the file `path`, see above. Throws std::runtime_error if the file
+ * 			cannot be written.
+ */
+inline void writeChromeTrace(const std::string &path) {
+	std::ofstream out(path);
+	if(!out) throw std::runtime_error("writeChromeTrace: cannot open " + path);
+	writeChromeTrace(out);
+	if(!out.flush()) throw std::runtime_error("writeChromeTrace: cannot write " + path);
+}
+
+} // namespace graph
+
+#endif // GRAPH_TRACE_HPP
@@ -0,0 +1,149 @@
+#ifndef GRAPH_TRANSPOSE_HPP
+#define GRAPH_TRANSPOSE_HPP
+
+#include "instrumentation.hpp"
+#include "parallel.hpp"
+#include "properties.hpp"
+#include "property_map.hpp"
+#include "simplify.hpp"
+#include "traits.hpp"
+
+#include <numeric>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace graph {
+namespace detail {
+
+/**
+ * @brief The (src, tar) pair or (src, tar, EdgeProp) triple addEdges() expects for an edge of `Graph`.
+ */
+template<typename Graph>
+using EdgeTuple = std::conditional_t<hasEdgeProp<Graph>,
+	std::tuple<typename Traits<Graph>::VertexDescriptor,
+	           typename Traits<Graph>::VertexDescriptor,
+	           typename Traits<Graph>::EdgeProp>,
+	std::pair<typename Traits<Graph>::VertexDescriptor,
+	          typename Traits<Graph>::VertexDescriptor>>;
+
+/**
+ * @brief Creates the addEdges() element for an edge from `src` to `tar` carrying the property of `e`.
+ */
+template<typename Graph, typename Vertex, typename Edge>
+EdgeTuple<Graph> makeEdgeTuple(Vertex src, Vertex tar, const Edge &e, const Graph &g) {
+	if constexpr(hasEdgeProp<Graph>) return {src, tar, g[e]};
+	else return {src, tar};
+}
+
+/**
+ * @return the edges of `g` in the order of edges(g).
+ */
+template<typename Graph>
+std::vector<typename Traits<Graph>::EdgeDescriptor> edgeVector(const Graph &g) {
+	std::vector<typename Traits<Graph>::EdgeDescriptor> es;
+	es.reserve(numEdges(g));
+	for(auto e : edges(g)) es.push_back(e);
+	return es;
+}
+
+} // namespace detail
+
+/**
+ * @brief Builds the reverse graph of `g`: every edge (u, v) becomes (v, u) and keeps its property.
+ * 			The edges are counting sorted by target in parallel, so the new edge list is grouped
+ * 			by new source and every adjacency list is filled with a single reservation.
+ * @tparam Graph graph type with a constructor taking the number of vertices and addEdges(), e.g. AdjacencyList
+ * @param g graph to transpose
+ * @param edgeMap property map keyed by the position `i` of an edge in edges(g), is set to the new
+ * 			storedEdgeIdx of that edge (its storedEdgeIdx for AdjacencyList). The map is written from
+ * 			the calling thread only, so any map works.
+ * @return the transposed graph, with the same vertices and vertex properties as `g`.
+ */
+template<typename Graph, ReadWritePropertyMap<std::size_t> EdgeMap>
+Graph transpose(const Graph &g, EdgeMap &edgeMap) {
+	GRAPH_PHASE("transpose");
+	const auto es = detail::edgeVector(g);
+	std::vector<std::size_t> positions(es.size());
+	std::iota(positions.begin(), positions.end(), 0);
+	positions = detail::countingSort(positions, numVertices(g), [&](std::size_t i) {
+		return getIndex(target(es[i], g), g);
+	});
+
+	std::vector<detail::EdgeTuple<Graph>> reversed(es.size());
+	detail::parallelFor(positions.size(), [&](std::size_t i) {
+		const auto &e = es[positions[i]];
+		reversed[i] = detail::makeEdgeTuple(target(e, g), source(e, g), e, g);
+	});
+	for(std::size_t i = 0; i < positions.size(); ++i) put(edgeMap, positions[i], i);
+
+	Graph res(numVertices(g));
+	detail::copyVertexProps(g, res);
+	addEdges(reversed, res);
+	return res;
+}
+
+/**
+ * @brief See above, with `edgeMap` resized to numEdges(g) and `edgeMap[i]` set for the edge at
+ * 			position `i` of edges(g).
+ */
+template<typename Graph>
+Graph transpose(const Graph &g, std::vector<std::size_t> &edgeMap) {
+	edgeMap.resize(numEdges(g));
+	detail::VectorRefMap<std::size_t> map{&edgeMap};
+	return transpose(g, map);
+}
+
+/**
+ * @brief See above, without reporting where the edges moved.
+ */
+template<typename Graph>
+Graph transpose(const Graph &g) {
+	detail::NullPropertyMap<std::size_t> edgeMap;
+	return transpose(g, edgeMap);
+}
+
+/**
+ * @brief Builds the symmetric closure of `g`: the result has the edges (u, v) and (v, u)
+ * 			for every edge (u, v) of `g`, each at most once, ordered by source and then target.
+ * 			If both (u, v) and (v, u) are in `g`, the property of the first added one is kept.
+ * @tparam Graph graph type with a constructor taking the number of vertices and addEdges(), e.g. AdjacencyList
+ * @param g graph to symmetrize
+ * @return the symmetrized graph, with the same vertices and vertex properties as `g`.
+ */
+template<typename Graph>
+Graph symmetrize(const Graph &g) {
+	GRAPH_PHASE("symmetrize");
+	const auto es = detail::edgeVector(g);
+	// position 2i is edge i, position 2i + 1 its reverse
+	std::vector<std::size_t> positions(2 * es.size());
+	std::iota(positions.begin(), positions.end(), 0);
+	auto src = [&](std::size_t i) {
+		const auto &e = es[i / 2];
+		return getIndex(i % 2 == 0 ? source(e, g) : target(e, g), g);
+	};
+	auto tar = [&](std::size_t i) {
+		const auto &e = es[i / 2];
+		return getIndex(i % 2 == 0 ? target(e, g) : source(e, g), g);
+	};
+	positions = detail::sortBySourceTarget(positions, numVertices(g), src, tar);
+
+	std::vector<detail::EdgeTuple<Graph>> sym;
+	sym.reserve(positions.size());
+	for(std::size_t k = 0; k < positions.size(); ++k) {
+		const std::size_t i = positions[k];
+		if(k > 0 && src(positions[k - 1]) == src(i) && tar(positions[k - 1]) == tar(i)) continue;
+		const auto &e = es[i / 2];
+		if(i % 2 == 0) sym.push_back(detail::makeEdgeTuple(source(e, g), target(e, g), e, g));
+		else sym.push_back(detail::makeEdgeTuple(target(e, g), source(e, g), e, g));
+	}
+
+	Graph res(numVertices(g));
+	detail::copyVertexProps(g, res);
+	addEdges(sym, res);
+	return res;
+}
+
+} // namespace graph
+
+#endif // GRAPH_TRANSPOSE_HPP
@@ -0,0 +1,134 @@
+#ifndef GRAPH_VISITORS_HPP
+#define GRAPH_VISITORS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+
+namespace graph {
+
+/**
+ * @brief Counters of one or more traversals, filled by a StatsVisitor. Counters of hooks an algorithm
+ * 			does not have stay zero, e.g. backEdges for bfs() or edgesRelaxed for dfs().
+ */
+struct TraversalStats {
+	std::size_t roots = 0;
+	std::size_t verticesDiscovered = 0;
+	std::size_t verticesFinished = 0;
+	std::size_t edgesExamined = 0;
+	std::size_t treeEdges = 0;
+	std::size_t backEdges = 0;
+	std::size_t forwardOrCrossEdges = 0;
+	std::size_t nonTreeEdges = 0;
+	std::size_t edgesRelaxed = 0;
+	// Vertices discovered but not finished: the stack of dfs(), the queue of bfs(), the heap of dijkstra().
+	std::size_t frontier = 0;
+	// Largest frontier seen, the maximum recursion depth for dfs().
+	std::size_t maxFrontier = 0;
+};
+
+/**
+ * @brief Visitor counting the events of dfs(), bfs() and dijkstra() into a TraversalStats.
+ * 			The algorithms copy their visitor, so the counters live behind a pointer.
+ * 			Use composeVisitors() to count alongside another visitor in the same traversal.
+ */
+struct StatsVisitor {
+	explicit StatsVisitor(TraversalStats &stats) : stats(&stats) {}
+
+	template<typename G, typename V>
+	void initVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void startVertex(const V&, const G&) { ++stats->roots; }
+
+	template<typename G, typename V>
+	void discoverVertex(const V&, const G&) {
+		++stats->verticesDiscovered;
+		stats->maxFrontier = std::max(stats->maxFrontier, ++stats->frontier);
+	}
+
+	template<typename G, typename V>
+	void examineVertex(const V&, const G&) { }
+
+	template<typename G, typename V>
+	void finishVertex(const V&, const G&) {
+		++stats->verticesFinished;
+		--stats->frontier;
+	}
+
+	template<typename G, typename E>
+	void examineEdge(const E&, const G&) { ++stats->edgesExamined; }
+
+	template<typename G, typename E>
+	void treeEdge(const E&, const G&) { ++stats->treeEdges; }
+
+	template<typename G, typename E>
+	void backEdge(const E&, const G&) { ++stats->backEdges; }
+
+	template<typename G, typename E>
+	void forwardOrCrossEdge(const E&, const G&) { ++stats->forwardOrCrossEdges; }
+
+	template<typename G, typename E>
+	void nonTreeEdge(const E&, const G&) { ++stats->nonTreeEdges; }
+
+	template<typename G, typename E>
+	void finishEdge(const E&, const G&) { }
+
+	template<typename G, typename E>
+	void edgeRelaxed(const E&, const G&) { ++stats->edgesRelaxed; }
+
+	template<typename G, typename E>
+	void edgeNotRelaxed(const E&, const G&) { }
+private:
+	TraversalStats *stats;
+};
+
+/**
+ * @brief Visitor calling every hook on each of `Visitors` in order, skipping the visitors that do not
+ * 			have it. The dispatch is resolved at compile time, so the composition inlines to the
+ * 			same code as one hand-written visitor and the graph is traversed once.
+ */
+template<typename... Visitors>
+struct ComposedVisitor {
+	explicit ComposedVisitor(Visitors... visitors) : visitors(std::move(visitors)...) {}
+
+#define GRAPH_COMPOSED_HOOK(hook) \
+	template<typename G, typename X> \
+	void hook(const X &x, const G &g) { \
+		std::apply([&](auto &...vs) { \
+			([&](auto &v) { if constexpr(requires { v.hook(x, g); }) v.hook(x, g); }(vs), ...); \
+		}, visitors); \
+	}
+
+	GRAPH_COMPOSED_HOOK(initVertex)
+	GRAPH_COMPOSED_HOOK(startVertex)
+	GRAPH_COMPOSED_HOOK(discoverVertex)
+	GRAPH_COMPOSED_HOOK(examineVertex)
+	GRAPH_COMPOSED_HOOK(finishVertex)
+	GRAPH_COMPOSED_HOOK(examineEdge)
+	GRAPH_COMPOSED_HOOK(treeEdge)
+	GRAPH_COMPOSED_HOOK(backEdge)
+	GRAPH_COMPOSED_HOOK(forwardOrCrossEdge)
+	GRAPH_COMPOSED_HOOK(nonTreeEdge)
+	GRAPH_COMPOSED_HOOK(finishEdge)
+	GRAPH_COMPOSED_HOOK(edgeRelaxed)
+	GRAPH_COMPOSED_HOOK(edgeNotRelaxed)
+
+#undef GRAPH_COMPOSED_HOOK
+private:
+	std::tuple<Visitors...> visitors;
+};
+
+/**
+ * @return a visitor forwarding every hook to each of `visitors` in order, e.g.
+ * 			dfs(g, composeVisitors(StatsVisitor(stats), TopoVisitor(out))).
+ */
+template<typename... Visitors>
+ComposedVisitor<Visitors...> composeVisitors(Visitors... visitors) {
+	return ComposedVisitor<Visitors...>(std::move(visitors)...);
+}
+
+} // namespace graph
+
+#endif // GRAPH_VISITORS_HPP
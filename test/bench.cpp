@@ -0,0 +1,250 @@
+/**
+ * Benchmarks of construction, traversal and I/O across graph sizes and storage types.
+ * Build with `make bench` and run `./bench.out [maxLog2Vertices] [repetitions] > results.json`.
+ * Every case runs `repetitions` times on the same seeded random DAG. The JSON
+ * reports the latency percentiles of the repetitions, the throughput in edges
+ * per second at the median latency, and the peak resident set size of the process
+ * during the case (the high-water mark is reset before every case), so consecutive
+ * runs can be diffed for regressions.
+ * Built with GRAPH_ENABLE_TRACING the phases are also written as a Chrome trace to bench_trace.json.
+ */
+#include "../src/graph/adjacency_list.hpp"
+#include "../src/graph/adjacency_matrix.hpp"
+#include "../src/graph/arena.hpp"
+#include "../src/graph/compressed_graph.hpp"
+#include "../src/graph/depth_first_search.hpp"
+#include "../src/graph/generators.hpp"
+#include "../src/graph/io.hpp"
+#include "../src/graph/storage.hpp"
+#include "../src/graph/tiled_matrix.hpp"
+#include "../src/graph/topological_sort.hpp"
+#include <sys/resource.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace graph;
+
+namespace {
+
+using EdgePairs = std::vector<std::pair<std::size_t, std::size_t>>;
+
+const std::size_t edgesPerVertex = 8;
+const std::uint64_t seed = 42;
+
+struct Result {
+    std::string benchmark, storage;
+    std::size_t vertices, edges;
+    double p50, p90, p99; // nanoseconds
+    long peakRssKiB;
+};
+
+std::vector<Result> results;
+// consumed by the benchmarks so the compiler cannot drop their work
+volatile std::size_t sink;
+
+// Peak resident set size over the lifetime of the process.
+long processPeakRssKiB() {
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+// Resets the high-water mark read by peakRssKiB() to the current resident set size.
+void resetPeakRss() {
+    std::ofstream("/proc/self/clear_refs") << "5";
+}
+
+// Peak resident set size since the last resetPeakRss(), or of the process if /proc is unavailable.
+long peakRssKiB() {
+    std::ifstream status("/proc/self/status");
+    for(std::string line; std::getline(status, line);)
+        if(line.rfind("VmHWM:", 0) == 0) return std::strtol(line.c_str() + 6, nullptr, 10);
+    return processPeakRssKiB();
+}
+
+// Nearest-rank percentile of the sorted `xs`.
+double percentile(const std::vector<double> &xs, double p) {
+    std::size_t rank = static_cast<std::size_t>(p / 100 * xs.size() + 0.5);
+    return xs[std::min(xs.size() - 1, rank == 0 ? 0 : rank - 1)];
+}
+
+void measure(const std::string &benchmark, const std::string &storage, std::size_t n, std::size_t m,
+             std::size_t reps, const std::function<void()> &run) {
+    std::vector<double> ns;
+    resetPeakRss();
+    for(std::size_t i = 0; i < reps; ++i) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        auto stop = std::chrono::steady_clock::now();
+        ns.push_back(std::chrono::duration<double, std::nano>(stop - start).count());
+    }
+    std::sort(ns.begin(), ns.end());
+    results.push_back(Result{benchmark, storage, n, m, percentile(ns, 50), percentile(ns, 90),
+                             percentile(ns, 99), peakRssKiB()});
+    std::cerr << benchmark << " " << storage << " n=" << n << ": " << percentile(ns, 50) / 1e6 << " ms\n";
+}
+
+std::string toDimacs(std::size_t n, const EdgePairs &es) {
+    std::ostringstream s;
+    s << "p edge " << n << " " << es.size() << "\n";
+    for(auto [u, v] : es) s << "e " << u + 1 << " " << v + 1 << "\n";
+    return s.str();
+}
+
+// Discards everything written to it, so printDot is measured without the cost of a growing string.
+struct NullBuffer : std::streambuf {
+    int overflow(int c) override { return c; }
+    std::streamsize xsputn(const char *, std::streamsize count) override { return count; }
+};
+
+struct CountingVisitor : DFSNullVisitor {
+    std::size_t *discovered;
+    template<typename G, typename V>
+    void discoverVertex(const V&, const G&) { ++*discovered; }
+};
+
+template<typename Graph>
+void benchTraversals(const std::string &storage, const Graph &g, std::size_t reps) {
+    const std::size_t n = numVertices(g), m = numEdges(g);
+    measure("outEdges", storage, n, m, reps, [&] {
+        std::size_t sum = 0;
+        for(auto v : vertices(g))
+            for(auto e : outEdges(v, g)) sum += getIndex(target(e, g), g);
+        sink = sum;
+    });
+    measure("dfs", storage, n, m, reps, [&] {
+        std::size_t discovered = 0;
+        dfs(g, CountingVisitor{{}, &discovered});
+        sink = discovered;
+    });
+    measure("topoSort", storage, n, m, reps, [&] {
+        std::vector<std::size_t> order;
+        order.reserve(n);
+        topoSort(g, std::back_inserter(order));
+        sink = order.size();
+    });
+    measure("printDot", storage, n, m, reps, [&] {
+        NullBuffer buffer;
+        std::ostream out(&buffer);
+        printDot(out, g);
+        sink = out.good();
+    });
+}
+
+// Times `build` as construction, then the traversals on one built graph.
+template<typename Build>
+void benchStorage(const std::string &storage, std::size_t n, std::size_t m, std::size_t reps, Build build) {
+    measure("construct", storage, n, m, reps, [&] { sink = numEdges(build()); });
+    benchTraversals(storage, build(), reps);
+}
+
+void benchSize(std::size_t n, std::size_t reps) {
+    // a DAG, so topoSort has a valid order; parallel edges are stored once by the matrix types
+    const EdgePairs es = randomDag(n, n * edgesPerVertex, seed).edges;
+    const std::size_t m = es.size();
+
+    benchStorage("AdjacencyList<Directed>", n, m, reps, [&] {
+        AdjacencyList<tags::Directed> g(n);
+        addEdges(es, g);
+        return g;
+    });
+    measure("constructIncremental", "AdjacencyList<Directed>", n, m, reps, [&] {
+        AdjacencyList<tags::Directed> g(n);
+        for(auto [u, v] : es) addEdge(u, v, g);
+        sink = numEdges(g);
+    });
+    benchStorage("AdjacencyList<Bidirectional>", n, m, reps, [&] {
+        AdjacencyList<tags::Bidirectional> g(n);
+        addEdges(es, g);
+        return g;
+    });
+    benchStorage("AdjacencyList<Directed,SmallStorage<8>>", n, m, reps, [&] {
+        AdjacencyList<tags::Directed, NoProp, NoProp, std::allocator<std::byte>, SmallStorage<8>> g(n);
+        addEdges(es, g);
+        return g;
+    });
+    {
+        // the graphs are returned by value, so every arena must outlive its graph
+        std::vector<std::unique_ptr<GraphArena>> arenas;
+        benchStorage("pmr::AdjacencyList<Directed>+GraphArena", n, m, reps, [&] {
+            arenas.push_back(std::make_unique<GraphArena>());
+            graph::pmr::AdjacencyList<tags::Directed> g(n, arenas.back().get());
+            addEdges(es, g);
+            return g;
+        });
+    }
+    {
+        AdjacencyList<tags::Directed> list(n);
+        addEdges(es, list);
+        benchStorage("CompressedGraph", n, m, reps, [&] { return CompressedGraph(list); });
+    }
+    benchStorage("TiledMatrix", n, m, reps, [&] {
+        TiledMatrix g(n);
+        addEdges(es, g);
+        return g;
+    });
+    // two n * n bitmaps, only for the smaller sizes
+    if(n <= (std::size_t(1) << 14)) {
+        benchStorage("AdjacencyMatrix", n, m, reps, [&] {
+            AdjacencyMatrix<> g(n);
+            addEdges(es, g);
+            return g;
+        });
+    }
+
+    const std::string dimacs = toDimacs(n, es);
+    measure("loadDimacs", "AdjacencyList<Directed>", n, m, reps, [&] {
+        std::istringstream in(dimacs);
+        sink = numEdges(loadDimacs<AdjacencyList<tags::Directed>>(in));
+    });
+    measure("loadDimacsSimplify", "AdjacencyList<Directed>", n, m, reps, [&] {
+        std::istringstream in(dimacs);
+        sink = numEdges(loadDimacs<AdjacencyList<tags::Directed>>(in, SimplifyOptions{}));
+    });
+}
+
+void printJson(std::ostream &s, std::size_t maxLog2, std::size_t reps) {
+    s << "{\n  \"config\": {\"maxLog2Vertices\": " << maxLog2 << ", \"repetitions\": " << reps
+      << ", \"edgesPerVertex\": " << edgesPerVertex << ", \"seed\": " << seed << "},\n";
+    s << "  \"results\": [\n";
+    for(std::size_t i = 0; i < results.size(); ++i) {
+        const Result &r = results[i];
+        s << "    {\"benchmark\": \"" << r.benchmark << "\", \"storage\": \"" << r.storage
+          << "\", \"vertices\": " << r.vertices << ", \"edges\": " << r.edges
+          << ", \"edgesPerSecond\": " << static_cast<std::uint64_t>(r.edges / (r.p50 * 1e-9))
+          << ", \"latencyNs\": {\"p50\": " << static_cast<std::uint64_t>(r.p50)
+          << ", \"p90\": " << static_cast<std::uint64_t>(r.p90)
+          << ", \"p99\": " << static_cast<std::uint64_t>(r.p99) << "}"
+          << ", \"peakRssKiB\": " << r.peakRssKiB << "}" << (i + 1 < results.size() ? "," : "") << "\n";
+    }
+    s << "  ],\n  \"peakRssKiB\": " << processPeakRssKiB() << "\n}\n";
+}
+
+} // namespace
+
+int main(int argc, char **argv) {
+    const std::size_t maxLog2 = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 16;
+    const std::size_t reps = argc > 2 ? std::strtoul(argv[2], nullptr, 10) : 7;
+    if(reps == 0) {
+        std::cerr << "usage: " << argv[0] << " [maxLog2Vertices] [repetitions], repetitions must be positive\n";
+        return 1;
+    }
+    for(std::size_t log2 = 10; log2 <= maxLog2; log2 += 2) benchSize(std::size_t(1) << log2, reps);
+    printJson(std::cout, maxLog2, reps);
+#ifdef GRAPH_ENABLE_PERF_COUNTERS
+    printPhaseReport(std::cerr);
+#endif
+#ifdef GRAPH_ENABLE_TRACING
+    // every thread keeps its newest events, earlier sizes may have been overwritten
+    writeChromeTrace("bench_trace.json");
+#endif
+}
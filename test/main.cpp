@@ -1,14 +1,71 @@
 
 // #include "graph/adjacency_list.hpp"
 #include "../src/graph/adjacency_list.hpp"
+#include "../src/graph/adjacency_matrix.hpp"
+#include "../src/graph/arena.hpp"
+#include "../src/graph/breadth_first_search.hpp"
+#include "../src/graph/compressed_graph.hpp"
 #include "../src/graph/concepts.hpp"
 #include "../src/graph/depth_first_search.hpp"
+#include "../src/graph/dijkstra_shortest_paths.hpp"
+#include "../src/graph/distributed.hpp"
+#include "../src/graph/edge_columns.hpp"
+#include "../src/graph/edge_index.hpp"
+#include "../src/graph/external.hpp"
+#include "../src/graph/filtered_graph.hpp"
+#include "../src/graph/generators.hpp"
+#include "../src/graph/io.hpp"
+#include "../src/graph/partition.hpp"
+#include "../src/graph/perf_counters.hpp"
+#include "../src/graph/property_map.hpp"
+#include "../src/graph/reorder.hpp"
+#include "../src/graph/reverse_graph.hpp"
+#include "../src/graph/simplify.hpp"
+#include "../src/graph/subgraph.hpp"
+#include "../src/graph/tiled_matrix.hpp"
 #include "../src/graph/topological_sort.hpp"
+#include "../src/graph/trace.hpp"
+#include "../src/graph/transpose.hpp"
+#include "../src/graph/visitors.hpp"
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <random>
+#include <set>
+#include <sstream>
+#include <thread>
 
 using namespace graph;
 
 void testTopoSort(int graphNr);
+void testEdgeLookup();
+void testSimplify();
+void testTranspose();
+void testViews();
+void testSubgraphs();
+void testReorder();
+void testPartition();
+void testDistributed();
+void testExternal();
+void testCompressed();
+void testEdgeColumns();
+void testPropertyMaps();
+void testVisitedSets();
+void testArena();
+void testSmallStorage();
+void testMemoryUsage();
+void testMatrixGrowth();
+void testMatrixInEdges();
+void testMatrixProperties();
+void testTiledMatrix();
+void testGenerators();
+void testPerfCounters();
+void testTraversalStats();
+void testTrace();
 
 int main() {
     /**
@@ -22,6 +79,31 @@ int main() {
     testTopoSort(3);
     std::cout << "\n";
 
+    testEdgeLookup();
+    testSimplify();
+    testTranspose();
+    testViews();
+    testSubgraphs();
+    testReorder();
+    testPartition();
+    testDistributed();
+    testExternal();
+    testCompressed();
+    testEdgeColumns();
+    testPropertyMaps();
+    testVisitedSets();
+    testArena();
+    testSmallStorage();
+    testMemoryUsage();
+    testMatrixGrowth();
+    testMatrixInEdges();
+    testMatrixProperties();
+    testTiledMatrix();
+    testGenerators();
+    testPerfCounters();
+    testTraversalStats();
+    testTrace();
+
 
     /**
      * @brief Checks if the concepts in concepts.hpp are satisfied
@@ -158,4 +240,1418 @@ void testTopoSort(int num) {
     //Print result of topo_sort
     for(auto i = vs.begin(); i != vs.end(); i++)
         std::cout << *i << std::endl;
-}
\ No newline at end of file
+}
+
+/**
+ * @brief Tests edge(u, v, g) on AdjacencyList, AdjacencyMatrix and EdgeIndex,
+ * 			with a hash threshold low enough that vertex 0 is hashed.
+ */
+void testEdgeLookup() {
+    using Graph = AdjacencyList<graph::tags::Directed>;
+    Graph g(40);
+    AdjacencyMatrix<> m(40);
+    for(std::size_t v = 1; v < 40; v += 2) {
+        addEdge(0, v, g);
+        addEdge(0, v, m);
+    }
+    addEdge(3, 1, g);
+    addEdge(3, 1, g); // parallel edge
+    addEdge(3, 1, m);
+
+    EdgeIndex<Graph> index(g, 4);
+    for(std::size_t v = 0; v < 40; ++v) {
+        bool expected = v % 2 == 1;
+        assert(edge(0, v, g).has_value() == expected);
+        assert(edge(0, v, index).has_value() == expected);
+        assert(edge(0, v, m).has_value() == expected);
+        assert(!edge(v, 0, index));
+    }
+    assert(edge(3, 1, g)->storedEdgeIdx == 20);
+    assert(edge(3, 1, index)->storedEdgeIdx == 20);
+    assert(edge(0, 39, index)->tar == 39);
+    assert(!edge(3, 2, index));
+    std::cout << "edge lookup: ok\n";
+}
+
+
+/**
+ * @brief Tests simplify() against a std::set of the expected edges, with enough edges
+ * 			and threads for the parallel radix sort to split the work, and loadDimacs deduplication.
+ */
+void testSimplify() {
+    setNumThreads(4);
+    using Graph = AdjacencyList<graph::tags::Bidirectional, NoProp, int>;
+    const std::size_t n = 100;
+    Graph g(n);
+    std::set<std::pair<std::size_t, std::size_t>> expected;
+    for(std::size_t i = 0; i < 20000; ++i) {
+        std::size_t src = (i * 7919) % n, tar = (i * 104729 + 13) % n;
+        addEdge(src, tar, 1, g);
+        if(src != tar) expected.emplace(src, tar);
+    }
+    Graph s = simplify(g, [](int &acc, const int &other) { acc += other; });
+    assert(numEdges(s) == expected.size());
+    int total = 0;
+    auto it = expected.begin();
+    for(auto e : edges(s)) {
+        assert(std::make_pair(e.src, e.tar) == *it++);
+        total += s[e];
+    }
+    int loops = 0;
+    for(auto e : edges(g)) loops += e.src == e.tar;
+    assert(total == int(numEdges(g)) - loops);
+    std::size_t inTotal = 0;
+    for(auto v : vertices(s)) inTotal += inDegree(v, s);
+    assert(inTotal == numEdges(s));
+
+    // a key range wider than one radix digit is sorted in several stable passes
+    std::vector<std::pair<std::size_t, std::size_t>> keyed(20000);
+    for(std::size_t i = 0; i < keyed.size(); ++i) keyed[i] = {(i * 2654435761u) % (std::size_t(1) << 33), i};
+    auto radix = graph::detail::countingSort(keyed, std::size_t(1) << 33, [](const auto &p) { return p.first; });
+    std::stable_sort(keyed.begin(), keyed.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+    assert(radix == keyed);
+
+    std::istringstream dimacs("p edge 3 5\ne 1 2\ne 1 2\ne 2 2\ne 3 1\ne 1 2\n");
+    auto d = loadDimacs<AdjacencyList<graph::tags::Directed>>(dimacs, SimplifyOptions{});
+    assert(numEdges(d) == 2);
+    dimacs.clear();
+    dimacs.seekg(0);
+    auto m = loadDimacs<AdjacencyMatrix<>>(dimacs, SimplifyOptions{true, false});
+    assert(numEdges(m) == 3 && edge(1, 1, m));
+    setNumThreads(0);
+    std::cout << "simplify: ok\n";
+}
+
+
+/**
+ * @brief Tests transpose() (including the edge map and properties) and symmetrize().
+ */
+void testTranspose() {
+    setNumThreads(4);
+    using Graph = AdjacencyList<graph::tags::Bidirectional, int, int>;
+    const std::size_t n = 50;
+    Graph g;
+    for(std::size_t v = 0; v < n; ++v) addVertex(int(v), g);
+    for(std::size_t i = 0; i < 10000; ++i)
+        addEdge((i * 31) % n, (i * 17 + 3) % n, int(i), g);
+
+    std::vector<std::size_t> edgeMap;
+    Graph t = transpose(g, edgeMap);
+    assert(numEdges(t) == numEdges(g));
+    for(auto e : edges(g)) {
+        Graph::EdgeDescriptor r(e.tar, e.src, edgeMap[e.storedEdgeIdx]);
+        assert(t[r] == g[e]);
+        assert((*std::next(edges(t).begin(), edgeMap[e.storedEdgeIdx])).src == e.tar);
+    }
+    for(auto v : vertices(g)) {
+        assert(t[v] == g[v]);
+        assert(outDegree(v, t) == inDegree(v, g));
+        assert(inDegree(v, t) == outDegree(v, g));
+    }
+
+    AdjacencyList<graph::tags::Directed> d(4);
+    addEdge(0, 1, d);
+    addEdge(1, 0, d);
+    addEdge(1, 2, d);
+    addEdge(3, 3, d);
+    auto sym = symmetrize(d);
+    assert(numEdges(sym) == 5);
+    assert(edge(2, 1, sym) && edge(0, 1, sym) && edge(3, 3, sym) && !edge(0, 2, sym));
+    setNumThreads(0);
+    std::cout << "transpose: ok\n";
+}
+
+
+/**
+ * @brief Tests that filteredGraph() and reverseGraph() views satisfy the concepts of the
+ * 			underlying graph and that dfs/topoSort run on them.
+ */
+void testViews() {
+    using Graph = AdjacencyList<graph::tags::Bidirectional, NoProp, int>;
+    Graph g(5);
+    addEdge(0, 1, 1, g);
+    addEdge(1, 2, 5, g);
+    addEdge(2, 3, 1, g);
+    addEdge(0, 3, 1, g);
+    addEdge(3, 4, 1, g);
+
+    auto light = [&g](const Graph::EdgeDescriptor &e) { return g[e] < 5; };
+    auto notFour = [](std::size_t v) { return v != 4; };
+    auto fg = filteredGraph(g, light, notFour);
+    using FG = decltype(fg);
+    static_assert(VertexListGraph<FG> && EdgeListGraph<FG> && BidirectionalGraph<FG>);
+    static_assert(BidirectionalGraph<FilteredGraph<AdjacencyMatrix<>, KeepAll>>);
+    static_assert(IncidenceGraph<FilteredGraph<CompressedGraph, KeepAll>>);
+    static_assert(!BidirectionalGraph<FilteredGraph<CompressedGraph, KeepAll>>);
+    assert(outDegree(1, fg) == 0 && outDegree(3, fg) == 0 && inDegree(3, fg) == 2);
+    assert(std::distance(edges(fg).begin(), edges(fg).end()) == 3);
+    assert(std::distance(vertices(fg).begin(), vertices(fg).end()) == 4);
+
+    std::vector<std::size_t> order;
+    topoSort(fg, std::back_inserter(order));
+    assert(order.size() == 4 && std::find(order.begin(), order.end(), 4) == order.end());
+
+    // views are values: they can be stored, copied and outlive the view they were copied from
+    std::vector<FG> views;
+    {
+        auto tmp = filteredGraph(g, light, notFour);
+        views.push_back(tmp);
+        views.push_back(std::move(tmp));
+    }
+    views[0] = views[1];
+    auto oe = outEdges(0, views[0]);
+    auto it = oe.begin();
+    it = oe.end();
+    assert(it == oe.end() && outDegree(0, views[1]) == 2 && inDegree(3, views[0]) == 2);
+
+    auto rg = reverseGraph(g);
+    using RG = decltype(rg);
+    static_assert(VertexListGraph<RG> && EdgeListGraph<RG> && BidirectionalGraph<RG>);
+    assert(outDegree(3, rg) == 2 && inDegree(3, rg) == 1);
+    for(auto e : outEdges(3, rg)) assert(source(e, rg) == 3 && rg[e] == g[e]);
+    order.clear();
+    topoSort(rg, std::back_inserter(order));
+    // finishing order of the reversed DAG is a topological order of g
+    std::vector<std::size_t> pos(5);
+    for(std::size_t i = 0; i < order.size(); ++i) pos[order[i]] = i;
+    for(auto e : edges(g)) assert(pos[source(e, g)] < pos[target(e, g)]);
+    std::cout << "views: ok\n";
+}
+
+
+/**
+ * @brief Tests inducedSubgraph() and egoNetworks() on a directed cycle with chords,
+ * 			with enough seeds for the extraction to run on several threads.
+ */
+void testSubgraphs() {
+    using Graph = AdjacencyList<graph::tags::Directed, int, NoProp>;
+    const std::size_t n = 10000;
+    Graph g;
+    for(std::size_t v = 0; v < n; ++v) addVertex(int(v), g);
+    for(std::size_t v = 0; v < n; ++v) {
+        addEdge(v, (v + 1) % n, g);
+        if(v % 3 == 0) addEdge(v, (v + 2) % n, g);
+    }
+
+    std::vector<std::size_t> set = {9, 10, 11, 12, 10};
+    auto sub = inducedSubgraph(g, set);
+    assert(numVertices(sub.graph) == 4 && sub.toOriginal[2] == 11);
+    assert(sub.graph[3] == 12);
+    assert(numEdges(sub.graph) == 4); // 9->10, 9->11, 10->11, 11->12
+    assert(edge(0, 2, sub.graph) && !edge(2, 0, sub.graph));
+
+    setNumThreads(3);
+    std::vector<std::size_t> seeds(n);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    auto egos = egoNetworks(g, seeds, 2);
+    assert(egos.size() == n);
+    for(std::size_t s = 0; s < n; ++s) {
+        auto ego = egos[s];
+        assert(ego.original(0) == s);
+        std::set<std::size_t> expected = {s, (s + 1) % n, (s + 2) % n};
+        if(s % 3 == 0) expected.insert((s + 3) % n);
+        if((s + 1) % 3 == 0) expected.insert((s + 3) % n);
+        assert(ego.numVertices() == expected.size());
+        std::size_t m = 0;
+        for(std::size_t j = 0; j < ego.numVertices(); ++j) {
+            assert(expected.count(ego.original(j)));
+            for(auto t : ego.neighbours(j)) {
+                assert(edge(ego.original(j), ego.original(t), g));
+                ++m;
+            }
+        }
+        auto check = inducedSubgraph(g, std::vector<std::size_t>(ego.vertices.begin(), ego.vertices.end()));
+        assert(m == numEdges(check.graph));
+    }
+    setNumThreads(0);
+    std::cout << "subgraphs: ok\n";
+}
+
+
+/**
+ * @brief Tests reorder() and the ordering heuristics on a randomly numbered 40x40 grid:
+ * 			every ordering is a permutation, reorder() keeps the structure, and the
+ * 			locality orderings beat the random numbering.
+ */
+void testReorder() {
+    using Graph = AdjacencyList<graph::tags::Bidirectional, int, int>;
+    const std::size_t side = 40, n = side * side;
+    std::vector<std::size_t> scramble(n);
+    std::iota(scramble.begin(), scramble.end(), 0);
+    std::shuffle(scramble.begin(), scramble.end(), std::mt19937(42));
+    Graph g;
+    for(std::size_t v = 0; v < n; ++v) addVertex(int(v), g);
+    for(std::size_t r = 0; r < side; ++r) {
+        for(std::size_t c = 0; c < side; ++c) {
+            std::size_t v = r * side + c;
+            if(c + 1 < side) addEdge(scramble[v], scramble[v + 1], int(v), g);
+            if(r + 1 < side) addEdge(scramble[v], scramble[v + side], int(v), g);
+        }
+    }
+    const double before = averageLogGap(g);
+
+    std::vector<std::vector<std::size_t>> perms = {
+        degreeSortOrder(g), bfsOrder(g, 0), reverseCuthillMcKeeOrder(g), gorderOrder(g)};
+    for(std::size_t i = 0; i < perms.size(); ++i) {
+        const auto &perm = perms[i];
+        std::vector<std::size_t> sorted = perm;
+        std::sort(sorted.begin(), sorted.end());
+        for(std::size_t v = 0; v < n; ++v) assert(sorted[v] == v);
+
+        std::vector<std::size_t> edgeMap;
+        Graph h = reorder(g, perm, edgeMap);
+        assert(numEdges(h) == numEdges(g));
+        for(auto v : vertices(g)) {
+            assert(h[perm[v]] == g[v]);
+            assert(outDegree(perm[v], h) == outDegree(v, g));
+        }
+        for(auto e : edges(g)) {
+            Graph::EdgeDescriptor r(perm[e.src], perm[e.tar], edgeMap[e.storedEdgeIdx]);
+            assert(h[r] == g[e]);
+            assert(edge(perm[e.src], perm[e.tar], h));
+        }
+        if(i > 0) assert(averageLogGap(h) < before);
+    }
+    std::cout << "reorder: ok\n";
+}
+
+
+/**
+ * @brief Tests partition() on a 100x100 grid: the parts must be balanced and the cut
+ * 			must be far below that of a random assignment.
+ */
+void testPartition() {
+    setNumThreads(4);
+    using Graph = AdjacencyList<graph::tags::Directed, NoProp, int>;
+    const std::size_t side = 100, n = side * side, k = 4;
+    Graph g(n);
+    for(std::size_t r = 0; r < side; ++r) {
+        for(std::size_t c = 0; c < side; ++c) {
+            std::size_t v = r * side + c;
+            if(c + 1 < side) addEdge(v, v + 1, 1, g);
+            if(r + 1 < side) addEdge(v, v + side, 1, g);
+        }
+    }
+    PartitionOptions opts;
+    auto part = partition(g, k, opts);
+    assert(part.size() == n);
+    std::vector<std::size_t> sizes(k, 0);
+    for(auto p : part) ++sizes.at(p);
+    for(auto s : sizes) assert(s <= std::size_t((1 + opts.imbalance) * n / k) + 1);
+    auto weight = [&g](const Graph::EdgeDescriptor &e) { return g[e]; };
+    const auto cut = edgeCut(g, part, weight);
+    // a random assignment cuts about 3/4 of the 19800 edges, optimal is 200
+    assert(cut < 1000);
+    // the matching is parallel but does not depend on the number of threads
+    setNumThreads(1);
+    assert(partition(g, k, opts) == part);
+    setNumThreads(4);
+    // zero weights must not merge or double count neighbours
+    auto zeroPart = partition(g, k, [](const Graph::EdgeDescriptor &) { return 0; }, opts);
+    std::fill(sizes.begin(), sizes.end(), 0);
+    for(auto p : zeroPart) ++sizes.at(p);
+    for(auto s : sizes) assert(s <= std::size_t((1 + opts.imbalance) * n / k) + 1);
+    std::cout << "partition: ok (cut " << cut << ")\n";
+    setNumThreads(0);
+}
+
+
+/**
+ * @brief Tests distributedBfs() and distributedPageRank() on 3 shards, once with one thread per
+ * 			rank and once with one forked process per rank, against sequential reference results.
+ */
+void testDistributed() {
+    using Graph = AdjacencyList<graph::tags::Directed>;
+    const std::size_t n = 300, k = 3;
+    Graph g(n);
+    for(std::size_t v = 0; v < n; ++v) {
+        addEdge(v, (v * 7 + 1) % n, g);
+        if(v % 5 != 0) addEdge(v, (v * 13 + 2) % n, g);
+    }
+    std::vector<std::size_t> dist(n, std::numeric_limits<std::size_t>::max()), queue = {0};
+    dist[0] = 0;
+    for(std::size_t i = 0; i < queue.size(); ++i) {
+        for(auto e : outEdges(queue[i], g)) {
+            if(dist[e.tar] != std::numeric_limits<std::size_t>::max()) continue;
+            dist[e.tar] = dist[queue[i]] + 1;
+            queue.push_back(e.tar);
+        }
+    }
+    std::vector<double> pr(n, 1.0 / n);
+    for(int it = 0; it < 20; ++it) {
+        std::vector<double> next(n, 0.15 / n);
+        for(auto v : vertices(g))
+            for(auto e : outEdges(v, g)) next[e.tar] += 0.85 * pr[v] / outDegree(v, g);
+        pr = next;
+    }
+
+    auto part = partition(g, k);
+    auto shards = shardGraph(g, part, k);
+    auto check = [&](Communicator &comm) {
+        const auto &shard = shards[comm.rank()];
+        auto d = distributedBfs(shard, comm, std::size_t(0));
+        auto r = distributedPageRank(shard, comm, 20);
+        bool ok = true;
+        for(std::size_t u = 0; u < shard.numOwned; ++u) {
+            ok = ok && d[u] == dist[shard.globalId[u]];
+            ok = ok && std::abs(r[u] - pr[shard.globalId[u]]) < 1e-12;
+        }
+        return ok;
+    };
+
+    auto comms = Communicator::createLocal(k);
+    std::vector<char> ok(k, false);
+    std::vector<std::thread> threads;
+    for(std::size_t r = 0; r < k; ++r)
+        threads.emplace_back([&, r] { ok[r] = check(comms[r]); });
+    for(auto &t : threads) t.join();
+    assert(std::all_of(ok.begin(), ok.end(), [](char c) { return c; }));
+
+    auto procComms = Communicator::createLocal(k);
+    assert(runProcesses(procComms, check));
+    std::cout << "distributed: ok\n";
+}
+
+
+/**
+ * @brief Tests the semi-external BFS, connected components and PageRank against in-memory results,
+ * 			with 4 KiB blocks so the edge file is streamed in many blocks, with and without O_DIRECT.
+ */
+void testExternal() {
+    using Graph = AdjacencyList<graph::tags::Directed>;
+    const std::size_t n = 5000;
+    Graph g(n);
+    // two components: a forward path with chords over [0, 4000), and a cycle over [4000, 5000)
+    for(std::size_t v = 0; v + 1 < 4000; ++v) {
+        addEdge(v, v + 1, g);
+        if(v % 7 == 0 && v + 10 < 4000) addEdge(v, v + 10, g);
+    }
+    for(std::size_t v = 4000; v < n; ++v) addEdge(v, v + 1 < n ? v + 1 : 4000, g);
+    addEdge(3999, 0, g);
+
+    const auto path = (std::filesystem::temp_directory_path() / "graph_external_test.bin").string();
+    writeBinaryAdjacency(g, path);
+    for(bool direct : {false, true}) {
+        SemiExternalGraph eg(path, ExternalOptions{4096, direct});
+        assert(numVertices(eg) == n && numEdges(eg) == numEdges(g));
+
+        std::vector<std::size_t> ref(n, std::numeric_limits<std::size_t>::max()), queue = {0};
+        ref[0] = 0;
+        for(std::size_t i = 0; i < queue.size(); ++i) {
+            for(auto e : outEdges(queue[i], g)) {
+                if(ref[e.tar] != std::numeric_limits<std::size_t>::max()) continue;
+                ref[e.tar] = ref[queue[i]] + 1;
+                queue.push_back(e.tar);
+            }
+        }
+        auto dist = externalBfs(eg, 0);
+        std::size_t passes = numPasses(eg);
+        for(std::size_t v = 0; v < n; ++v) assert(dist[v] == ref[v]);
+        // edges point forward in file order, so one pass settles everything and one confirms it
+        assert(passes == 2);
+
+        auto comp = externalConnectedComponents(eg);
+        assert(numPasses(eg) == passes + 1);
+        for(std::size_t v = 0; v < n; ++v) assert(comp[v] == (v < 4000 ? 0 : 4000));
+
+        auto pr = externalPageRank(eg, 10);
+        std::vector<double> refPr(n, 1.0 / n);
+        for(int it = 0; it < 10; ++it) {
+            std::vector<double> next(n, 0.15 / n);
+            for(auto v : vertices(g))
+                for(auto e : outEdges(v, g)) next[e.tar] += 0.85 * refPr[v] / outDegree(v, g);
+            refPr = next;
+        }
+        for(std::size_t v = 0; v < n; ++v) assert(std::abs(pr[v] - refPr[v]) < 1e-12);
+    }
+
+    // a corrupt offset table is rejected on load, a target that is not a vertex during the scan
+    auto patch = [&](std::size_t pos, const auto &value) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(static_cast<std::streamoff>(pos));
+        file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+    };
+    const std::size_t offsetsPos = 8 + 2 * sizeof(std::uint64_t);
+    patch(offsetsPos + sizeof(std::uint64_t), std::uint64_t(numEdges(g) + 1));
+    bool thrown = false;
+    try { SemiExternalGraph corrupt(path); } catch(const std::runtime_error&) { thrown = true; }
+    assert(thrown);
+    writeBinaryAdjacency(g, path);
+    patch(graph::detail::targetsOffset(n), std::uint32_t(n));
+    SemiExternalGraph badTarget(path);
+    thrown = false;
+    try { externalBfs(badTarget, 0); } catch(const std::runtime_error&) { thrown = true; }
+    assert(thrown);
+    std::filesystem::remove(path);
+    std::cout << "external: ok\n";
+}
+
+
+/**
+ * @brief Tests CompressedGraph against the adjacency list it is built from, for several skip
+ * 			intervals: out edges, degrees, edge() lookups and the edge indices of edges().
+ */
+void testCompressed() {
+    static_assert(IncidenceGraph<CompressedGraph>);
+    static_assert(VertexListGraph<CompressedGraph>);
+    static_assert(EdgeListGraph<CompressedGraph>);
+
+    using Graph = AdjacencyList<graph::tags::Directed>;
+    const std::size_t n = 3000;
+    Graph g(n);
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    // a hub with many (partly parallel) edges to exercise the skip pointers, plus random edges
+    for(std::size_t i = 0; i < 1000; ++i) addEdge(7, pick(rng) % 600, g);
+    for(std::size_t i = 0; i < 20000; ++i) addEdge(pick(rng), pick(rng), g);
+
+    for(std::size_t interval : {1, 4, 64}) {
+        CompressedGraph cg(g, interval);
+        assert(numVertices(cg) == n && numEdges(cg) == numEdges(g));
+        std::size_t count = 0;
+        for(auto v : vertices(g)) {
+            std::vector<std::size_t> expected, actual;
+            for(auto e : outEdges(v, g)) expected.push_back(e.tar);
+            std::sort(expected.begin(), expected.end());
+            for(auto e : outEdges(v, cg)) {
+                assert(source(e, cg) == v);
+                actual.push_back(target(e, cg));
+            }
+            assert(actual == expected && outDegree(v, cg) == expected.size());
+            for(std::size_t t = 0; t < n; t += (v == 7 ? 1 : 97)) {
+                auto e = edge(v, t, cg);
+                auto it = std::lower_bound(expected.begin(), expected.end(), t);
+                assert(e.has_value() == (it != expected.end() && *it == t));
+                if(e) assert(target(*e, cg) == t && e->idx - (*outEdges(v, cg).begin()).idx == std::size_t(it - expected.begin()));
+            }
+        }
+        for(auto e : edges(cg)) {
+            assert(e.idx == count++);
+            assert(edge(source(e, cg), target(e, cg), cg).has_value());
+        }
+        assert(count == numEdges(g));
+    }
+    std::cout << "compressed: ok\n";
+}
+
+
+struct Road {
+    double length;
+    int lanes;
+};
+
+/**
+ * @brief Tests EdgeColumns against the edge properties and relaxEdges() against a
+ * 			Bellman-Ford scan over the graph, for floating point and saturating integer distances.
+ */
+void testEdgeColumns() {
+    using Graph = AdjacencyList<graph::tags::Bidirectional, NoProp, Road>;
+    const std::size_t n = 500;
+    Graph g(n);
+    std::mt19937 rng(5);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    std::uniform_real_distribution<double> len(1, 10);
+    for(std::size_t i = 0; i < 4000; ++i) addEdge(pick(rng), pick(rng), Road{len(rng), int(i % 4) + 1}, g);
+
+    EdgeColumns<Graph, &Road::length, &Road::lanes> cols(g);
+    assert(cols.size() == numEdges(g));
+    auto lengths = cols.column<&Road::length>();
+    auto lanes = cols.column<1>();
+    std::size_t i = 0;
+    for(auto e : edges(g)) {
+        assert(cols.sources()[i] == source(e, g) && cols.targets()[i] == target(e, g));
+        assert(lengths[i] == g[e].length && lanes[i] == g[e].lanes);
+        ++i;
+    }
+
+    // Bellman-Ford on the length column against a scan over the graph
+    std::vector<double> dist(n, infiniteDistance<double>()), ref = dist;
+    dist[0] = ref[0] = 0;
+    while(relaxEdges(cols.sources(), cols.targets(), lengths, dist)) {}
+    for(bool changed = true; changed;) {
+        changed = false;
+        for(auto e : edges(g)) {
+            if(ref[e.src] + g[e].length < ref[e.tar]) {
+                ref[e.tar] = ref[e.src] + g[e].length;
+                changed = true;
+            }
+        }
+    }
+    assert(dist == ref);
+
+    // a scalar EdgeProp is a single column, integer distances saturate at the maximum
+    using WGraph = AdjacencyList<graph::tags::Directed, NoProp, int>;
+    WGraph w(4);
+    addEdge(0, 1, 5, w);
+    addEdge(1, 2, 7, w);
+    addEdge(0, 2, 20, w);
+    EdgeColumns<WGraph> wcols(w);
+    std::vector<long> wdist(4, infiniteDistance<long>());
+    wdist[0] = 0;
+    while(relaxEdges(wcols.sources(), wcols.targets(), wcols.column<0>(), wdist)) {}
+    assert(wdist[1] == 5 && wdist[2] == 12 && wdist[3] == infiniteDistance<long>());
+    const std::vector<int> tooFew(numEdges(w) - 1, 1);
+    bool thrown = false;
+    try { relaxEdges(wcols.sources(), wcols.targets(), tooFew, wdist); } catch(const std::invalid_argument&) { thrown = true; }
+    assert(thrown);
+    std::cout << "edge columns: ok\n";
+}
+
+
+/**
+ * @brief Tests the bit, sparse and atomic property maps, topoSort() with reused and
+ * 			sparse colour maps, and the map overloads of the other algorithms.
+ */
+void testPropertyMaps() {
+    static_assert(ReadWritePropertyMap<VectorPropertyMap<int>, int>);
+    static_assert(ReadWritePropertyMap<BitPropertyMap, bool>);
+    static_assert(ReadWritePropertyMap<AtomicPropertyMap<int>, int>);
+    static_assert(ReadWritePropertyMap<SparsePropertyMap<int>, int>);
+
+    BitPropertyMap bits(130);
+    put(bits, 0, true);
+    put(bits, 64, true);
+    put(bits, 129, true);
+    put(bits, 64, false);
+    assert(get(bits, 0) && !get(bits, 64) && get(bits, 129) && !get(bits, 128));
+    bits.assign(70, true);
+    assert(bits.size() == 70 && get(bits, 69));
+
+    SparsePropertyMap<int> sparse(-1);
+    put(sparse, 1000000, 3);
+    assert(get(sparse, 1000000) == 3 && get(sparse, 5) == -1 && sparse.size() == 1);
+
+    // every index is claimed by exactly one thread
+    AtomicPropertyMap<int> owner(1000, -1);
+    std::vector<std::thread> threads;
+    std::atomic<int> claimed{0};
+    for(int t = 0; t < 4; ++t) {
+        threads.emplace_back([&, t] {
+            for(std::size_t i = 0; i < 1000; ++i)
+                if(compareExchange(owner, i, -1, t)) ++claimed;
+        });
+    }
+    for(auto &t : threads) t.join();
+    assert(claimed == 1000);
+    for(std::size_t i = 0; i < 1000; ++i) assert(get(owner, i) >= 0);
+
+    // topoSort with reused and sparse colour maps agrees with the default
+    using Graph = AdjacencyList<graph::tags::Directed>;
+    const std::size_t n = 300;
+    Graph g(n);
+    std::mt19937 rng(3);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    for(std::size_t i = 0; i < 1500; ++i) {
+        auto a = pick(rng), b = pick(rng);
+        if(a != b) addEdge(std::min(a, b), std::max(a, b), g);
+    }
+    std::vector<std::size_t> expected;
+    topoSort(g, std::back_inserter(expected));
+    auto colour = makeVertexMap<DFSColour>(g);
+    for(int run = 0; run < 2; ++run) {
+        std::vector<std::size_t> order;
+        topoSort(g, std::back_inserter(order), colour);
+        assert(order == expected);
+        for(auto v : vertices(g)) assert(colour[v] == DFSColour::Black);
+    }
+    SparsePropertyMap<DFSColour> sparseColour;
+    std::vector<std::size_t> order;
+    topoSort(g, std::back_inserter(order), sparseColour);
+    assert(order == expected);
+
+    // the other algorithms take maps for their outputs and index scratch space
+    std::vector<std::size_t> edgeVec;
+    auto t = transpose(g, edgeVec);
+    SparsePropertyMap<std::size_t> edgeMap;
+    auto t2 = transpose(g, edgeMap);
+    assert(numEdges(t2) == numEdges(t));
+    for(std::size_t i = 0; i < edgeVec.size(); ++i) assert(get(edgeMap, i) == edgeVec[i]);
+    auto perm = degreeSortOrder(g);
+    auto r = reorder(g, perm, edgeVec);
+    VectorPropertyMap<std::size_t> reorderMap(numEdges(g));
+    reorder(g, perm, reorderMap);
+    for(std::size_t i = 0; i < edgeVec.size(); ++i) assert(get(reorderMap, i) == edgeVec[i]);
+
+    GenerationPropertyMap<std::size_t> toNew(n, std::numeric_limits<std::size_t>::max());
+    for(std::size_t first = 0; first < 60; first += 20) {
+        std::vector<std::size_t> subset(20);
+        std::iota(subset.begin(), subset.end(), first);
+        toNew.clear();
+        auto sub = inducedSubgraph(g, subset, toNew);
+        auto ref = inducedSubgraph(g, subset);
+        assert(numVertices(sub.graph) == 20 && numEdges(sub.graph) == numEdges(ref.graph));
+        assert(sub.toOriginal == ref.toOriginal && get(toNew, first + 3) == 3);
+    }
+
+    auto unit = [](const auto&) { return 1; };
+    VectorPropertyMap<std::size_t> partMap(n);
+    partition(g, 3, unit, partMap);
+    auto partVec = partition(g, 3, unit);
+    for(std::size_t v = 0; v < n; ++v) assert(get(partMap, v) == partVec[v]);
+    // without coarsening the whole partition is computed in the map
+    PartitionOptions flat;
+    flat.coarsenTo = n;
+    SparsePropertyMap<std::size_t> sparseParts;
+    partition(g, 3, unit, sparseParts, flat);
+    partVec = partition(g, 3, unit, flat);
+    for(std::size_t v = 0; v < n; ++v) assert(get(sparseParts, v) == partVec[v]);
+
+    // orderings take their visited maps, ego networks their per-thread maps, from the caller
+    BitPropertyMap visited(n);
+    assert(bfsOrder(g, 0, visited) == bfsOrder(g, 0) && get(visited, n - 1));
+    visited.assign(n, false);
+    assert(reverseCuthillMcKeeOrder(g, visited) == reverseCuthillMcKeeOrder(g));
+    visited.assign(n, false);
+    assert(gorderOrder(g, visited) == gorderOrder(g));
+    EgoScratch scratch;
+    std::vector<std::size_t> seeds(n);
+    std::iota(seeds.begin(), seeds.end(), 0);
+    for(int run = 0; run < 2; ++run) {
+        auto egos = egoNetworks(g, seeds, 2, scratch);
+        auto ref = egoNetworks(g, seeds, 2);
+        assert(egos.vertices == ref.vertices && egos.targets == ref.targets);
+    }
+    std::cout << "property maps: ok\n";
+}
+
+
+/**
+ * @brief Tests TwoBitPropertyMap, GenerationVisitedSet and repeated topoSortFrom() runs on
+ * 			a big graph with a GenerationPropertyMap.
+ */
+void testVisitedSets() {
+    TwoBitPropertyMap<DFSColour> packed(100, DFSColour::Grey);
+    assert(get(packed, 99) == DFSColour::Grey);
+    put(packed, 31, DFSColour::Black);
+    put(packed, 32, DFSColour::White);
+    assert(get(packed, 31) == DFSColour::Black && get(packed, 32) == DFSColour::White && get(packed, 30) == DFSColour::Grey);
+
+    GenerationVisitedSet visited(10);
+    assert(visited.insert(3) && !visited.insert(3) && visited.contains(3));
+    visited.clear();
+    assert(!visited.contains(3) && visited.insert(3));
+
+    // a chain 0 -> 1 -> ... -> 9 with a branch 2 -> 10 inside a big graph of isolated vertices
+    using Graph = AdjacencyList<graph::tags::Directed>;
+    Graph g(100000);
+    for(std::size_t v = 0; v < 9; ++v) addEdge(v, v + 1, g);
+    addEdge(2, 10, g);
+
+    GenerationPropertyMap<DFSColour> colour(numVertices(g), DFSColour::White);
+    for(int run = 0; run < 3; ++run) {
+        std::vector<std::size_t> order;
+        topoSortFrom(g, 5, std::back_inserter(order), colour);
+        assert((order == std::vector<std::size_t>{9, 8, 7, 6, 5}));
+        // a second start continues the same sort until the map is cleared
+        topoSortFrom(g, 0, std::back_inserter(order), colour);
+        assert((order == std::vector<std::size_t>{9, 8, 7, 6, 5, 4, 3, 10, 2, 1, 0}));
+        assert(get(colour, 11) == DFSColour::White);
+        colour.clear();
+        assert(get(colour, 5) == DFSColour::White);
+    }
+
+    // the default dfs now uses the packed map and still agrees with a vector map
+    std::vector<std::size_t> a, b;
+    topoSort(g, std::back_inserter(a));
+    auto vec = makeVertexMap<DFSColour>(g);
+    topoSort(g, std::back_inserter(b), vec);
+    assert(a == b);
+    std::cout << "visited sets: ok\n";
+}
+
+
+/**
+ * @brief Tests pmr::AdjacencyList in a GraphArena against an std::allocator graph, for single
+ * 			and bulk insertion, and the release of the arena.
+ */
+void testArena() {
+    static_assert(MutablePropertyGraph<graph::pmr::AdjacencyList<tags::Bidirectional, int, int>>);
+
+    const std::size_t n = 2000;
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for(std::size_t i = 0; i < 10000; ++i) pairs.emplace_back(pick(rng), pick(rng));
+
+    AdjacencyList<graph::tags::Bidirectional> ref(n);
+    for(auto [a, b] : pairs) addEdge(a, b, ref);
+
+    GraphArena arena(4096);
+    {
+        using Graph = graph::pmr::AdjacencyList<graph::tags::Bidirectional, int>;
+        Graph g(n, &arena);
+        assert(g.get_allocator().resource() == &arena);
+        for(auto [a, b] : pairs) addEdge(a, b, g);
+        auto v = addVertex(7, g);
+        assert(g[v] == 7 && numVertices(g) == n + 1);
+        // the vertex array, the edge list and every adjacency list live in the arena
+        assert(arena.bytesAllocated() >= 3 * pairs.size() * sizeof(std::size_t));
+        assert(arena.numChunks() < 20 && arena.bytesReserved() >= arena.bytesAllocated());
+        for(std::size_t u = 0; u < n; ++u) {
+            assert(outDegree(u, g) == outDegree(u, ref) && inDegree(u, g) == inDegree(u, ref));
+            auto it = outEdges(u, ref).begin();
+            for(auto e : outEdges(u, g)) assert(target(e, g) == target(*it++, ref));
+        }
+    }
+    // addEdges() reserves every list once, so bulk building wastes little arena space
+    GraphArena bulk;
+    {
+        graph::pmr::AdjacencyList<graph::tags::Directed> h(0, &bulk);
+        for(std::size_t i = 0; i < n; ++i) addVertex(h);
+        std::size_t before = bulk.bytesAllocated();
+        addEdges(pairs, h);
+        assert(numEdges(h) == pairs.size());
+        assert(bulk.bytesAllocated() - before < 2 * pairs.size() * 2 * sizeof(std::size_t) + n * 64);
+    }
+    bulk.release();
+    assert(bulk.bytesReserved() == 0);
+
+    // the most recent allocation is rolled back, an exact fit stays in the chunk
+    GraphArena small(256);
+    void *a = small.allocate(40, 8);
+    void *b = small.allocate(24, 8);
+    small.deallocate(b, 24, 8);
+    assert(small.bytesAllocated() == 40 && small.allocate(24, 8) == b);
+    small.deallocate(a, 40, 8);
+    assert(small.bytesAllocated() == 64);
+    (void)small.allocate(256 - 64, 8);
+    assert(small.numChunks() == 1);
+    (void)small.allocate(1, 1);
+    void *aligned = small.allocate(16, 64);
+    assert(small.numChunks() == 2 && reinterpret_cast<std::uintptr_t>(aligned) % 64 == 0);
+    std::cout << "arena: ok\n";
+}
+
+
+/**
+ * @brief Tests SmallStorage edge lists against VectorStorage, with a hub that spills to the heap,
+ * 			and in combination with the arena allocator.
+ */
+void testSmallStorage() {
+    using Small = AdjacencyList<graph::tags::Bidirectional, int, int, std::allocator<std::byte>, SmallStorage<4>>;
+    static_assert(MutablePropertyGraph<Small>);
+    static_assert(BidirectionalGraph<Small>);
+
+    const std::size_t n = 1000;
+    std::mt19937 rng(4);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    // mostly degree below 4, with vertex 0 as a hub that spills to the heap
+    std::vector<std::tuple<std::size_t, std::size_t, int>> es;
+    for(std::size_t i = 0; i < 2 * n; ++i) es.emplace_back(pick(rng), pick(rng), int(i));
+    for(std::size_t i = 0; i < 100; ++i) es.emplace_back(0, pick(rng), -int(i));
+
+    AdjacencyList<graph::tags::Bidirectional, int, int> ref(n);
+    Small g(n);
+    for(auto [a, b, w] : es) {
+        addEdge(a, b, int(w), ref);
+        addEdge(a, b, int(w), g);
+    }
+    Small bulk(n);
+    addEdges(es, bulk);
+    for(std::size_t v = 0; v < n; ++v) {
+        assert(outDegree(v, g) == outDegree(v, ref) && inDegree(v, g) == inDegree(v, ref));
+        auto it = outEdges(v, ref).begin();
+        auto bit = outEdges(v, bulk).begin();
+        for(auto e : outEdges(v, g)) {
+            assert(target(e, g) == target(*it, ref) && g[e] == ref[*it++]);
+            assert(bulk[*bit++] == g[e]);
+        }
+        auto jt = inEdges(v, ref).begin();
+        for(auto e : inEdges(v, g)) assert(source(e, g) == source(*jt++, ref));
+    }
+
+    // inline buffers combine with the arena allocator
+    GraphArena arena;
+    graph::pmr::AdjacencyList<graph::tags::Directed, NoProp, NoProp, SmallStorage<2>> h(n, &arena);
+    for(auto [a, b, w] : es) addEdge(a, b, h);
+    assert(numEdges(h) == es.size() && outDegree(0, h) == outDegree(0, ref));
+    std::cout << "small storage: ok\n";
+}
+
+
+/**
+ * @brief Tests memoryUsage() and shrinkToFit() of the adjacency list, the inline storage,
+ * 			the adjacency matrix and CompressedGraph.
+ */
+void testMemoryUsage() {
+    const std::size_t n = 1000;
+    std::mt19937 rng(8);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for(std::size_t i = 0; i < 3000; ++i) pairs.emplace_back(pick(rng), pick(rng));
+
+    AdjacencyList<graph::tags::Bidirectional, int, double> g(n);
+    for(auto [a, b] : pairs) addEdge(a, b, g);
+    MemoryUsage before = memoryUsage(g);
+    assert(before.edgeArray == pairs.size() * 2 * sizeof(std::size_t));
+    assert(before.properties == n * sizeof(int) + pairs.size() * sizeof(double));
+    assert(before.adjacencySize == 2 * pairs.size() * sizeof(std::size_t));
+    assert(before.adjacencyCapacity >= before.adjacencySize && before.slack > 0);
+    shrinkToFit(g);
+    MemoryUsage after = memoryUsage(g);
+    assert(after.slack == 0 && after.adjacencyCapacity == after.adjacencySize);
+    assert(after.total() == before.total() - before.slack);
+    assert(numEdges(g) == pairs.size());
+
+    // with inline storage only the spilled edge lists count as adjacency entries
+    AdjacencyList<graph::tags::Directed, NoProp, NoProp, std::allocator<std::byte>, SmallStorage<8>> small(n);
+    addEdges(pairs, small);
+    std::size_t spilled = 0;
+    for(auto v : vertices(small)) if(outDegree(v, small) > 8) spilled += outDegree(v, small);
+    assert(memoryUsage(small).adjacencySize == spilled * sizeof(std::size_t));
+
+    AdjacencyMatrix<> m(100);
+    addEdge(1, 2, m);
+    // one bit per cell, 100 vertices need two words per row and per column
+    assert(memoryUsage(m).edgeArray == 100 * 2 * sizeof(std::uint64_t));
+    assert(memoryUsage(m).total() == 2 * 100 * 2 * sizeof(std::uint64_t));
+
+    AdjacencyList<graph::tags::Directed> d(n);
+    addEdges(pairs, d);
+    // read-only, so it is trimmed on construction
+    CompressedGraph cg(d);
+    assert(memoryUsage(cg).slack == 0);
+    assert(memoryUsage(cg).edgeArray < memoryUsage(d).edgeArray / 4);
+    std::cout << "memory usage: ok\n";
+}
+
+
+/**
+ * @brief Tests AdjacencyMatrix growing one vertex at a time, bulk insertion, edge removal
+ * 			and shrinkToFit().
+ */
+void testMatrixGrowth() {
+    static_assert(MutableGraph<AdjacencyMatrix<>>);
+    const std::size_t n = 300;
+    std::mt19937 rng(9);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for(std::size_t i = 0; i < 2000; ++i) pairs.emplace_back(pick(rng), pick(rng));
+
+    // grow one vertex at a time while adding edges among the existing vertices
+    AdjacencyMatrix<> g;
+    AdjacencyList<graph::tags::Directed> ref(n);
+    std::set<std::pair<std::size_t, std::size_t>> seen;
+    for(std::size_t v = 0; v < n; ++v) {
+        assert(addVertex(g) == v);
+        for(auto [a, b] : pairs)
+            if(std::max(a, b) == v && seen.insert({a, b}).second) {
+                addEdge(a, b, g);
+                addEdge(a, b, ref);
+            }
+    }
+    assert(numVertices(g) == n && numEdges(g) == seen.size());
+    for(auto v : vertices(g)) {
+        assert(outDegree(v, g) == outDegree(v, ref));
+        for(auto e : outEdges(v, ref)) assert(edge(v, target(e, ref), g));
+    }
+    assert(std::distance(edges(g).begin(), edges(g).end()) == (long)seen.size());
+
+    // bulk insertion skips duplicates, removal keeps the edge count
+    AdjacencyMatrix<> h(n);
+    addEdges(pairs, h);
+    assert(numEdges(h) == seen.size());
+    for(auto [a, b] : seen) assert(edge(a, b, h));
+    auto [a, b] = *seen.begin();
+    removeEdge(a, b, h);
+    assert(!edge(a, b, h) && numEdges(h) == seen.size() - 1);
+    for(auto [a, b] : seen) if(edge(a, b, h)) removeEdge(*edge(a, b, h), h);
+    assert(numEdges(h) == 0 && edges(h).begin() == edges(h).end());
+
+    // dropping the spare capacity keeps the edges
+    assert(memoryUsage(g).slack > 0);
+    shrinkToFit(g);
+    assert(memoryUsage(g).slack == 0 && numEdges(g) == seen.size());
+    for(auto [a, b] : seen) assert(edge(a, b, g));
+    std::cout << "matrix growth: ok\n";
+}
+
+
+/**
+ * @brief Tests the in edges of AdjacencyMatrix, kept in column bitmaps, against its out edges
+ * 			through reverseGraph().
+ */
+void testMatrixInEdges() {
+    static_assert(BidirectionalGraph<AdjacencyMatrix<>>);
+    const std::size_t n = 150;
+    std::mt19937 rng(10);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1);
+    std::vector<std::pair<std::size_t, std::size_t>> pairs;
+    for(std::size_t i = 0; i < 3000; ++i) pairs.emplace_back(pick(rng), pick(rng));
+
+    // grow past several word boundaries so the column bitmaps are moved
+    AdjacencyMatrix<> g;
+    for(std::size_t v = 0; v < n; ++v) addVertex(g);
+    addEdges(pairs, g);
+    std::set<std::pair<std::size_t, std::size_t>> seen(pairs.begin(), pairs.end());
+    for(std::size_t i = 0; i < 500; ++i) {
+        auto [a, b] = pairs[i];
+        if(seen.erase({a, b})) removeEdge(a, b, g);
+    }
+    shrinkToFit(g);
+
+    auto rg = reverseGraph(g);
+    std::size_t total = 0;
+    for(auto v : vertices(g)) {
+        std::size_t expected = 0;
+        for(auto [a, b] : seen) expected += b == v;
+        assert(inDegree(v, g) == expected);
+        std::size_t prev = 0, count = 0;
+        for(auto e : inEdges(v, g)) {
+            // in-edges come out ordered by source
+            assert(target(e, g) == v && seen.count({source(e, g), v}));
+            assert(count++ == 0 || source(e, g) > prev);
+            prev = source(e, g);
+        }
+        assert(count == expected && outDegree(v, rg) == expected);
+        total += count;
+    }
+    assert(total == numEdges(g) && total == seen.size());
+    std::cout << "matrix in-edges: ok\n";
+}
+
+
+/**
+ * @brief Tests vertex and edge properties of AdjacencyMatrix across growth, removal and
+ * 			bulk insertion.
+ */
+void testMatrixProperties() {
+    using Weighted = AdjacencyMatrix<int, double>;
+    static_assert(MutablePropertyGraph<Weighted> && BidirectionalGraph<Weighted>);
+    static_assert(!PropertyGraph<AdjacencyMatrix<>>);
+
+    Weighted g(3);
+    g[0] = 10;
+    addEdge(0, 1, 1.5, g);
+    addEdge(1, 2, g);
+    auto v = addVertex(7, g);
+    assert(v == 3 && g[3] == 7 && g[0] == 10);
+    addEdge(2, 3, 4.0, g);
+    assert(g[*edge(0, 1, g)] == 1.5 && g[*edge(1, 2, g)] == 0.0 && g[*edge(2, 3, g)] == 4.0);
+    g[*edge(1, 2, g)] = 2.5;
+
+    // growth moves the properties with their cells
+    for(int i = 0; i < 100; ++i) addVertex(int(i), g);
+    addEdge(102, 0, 9.0, g);
+    assert(g[*edge(1, 2, g)] == 2.5 && g[*edge(2, 3, g)] == 4.0 && g[102] == 98);
+    double sum = 0;
+    for(auto e : edges(g)) sum += g[e];
+    assert(sum == 1.5 + 2.5 + 4.0 + 9.0);
+    for(auto e : inEdges(0, g)) assert(source(e, g) == 102 && g[e] == 9.0);
+
+    // removing and re-adding an edge resets its property
+    removeEdge(1, 2, g);
+    addEdge(1, 2, g);
+    assert(g[*edge(1, 2, g)] == 0.0);
+
+    // bulk triples set the property of new edges only
+    std::vector<std::tuple<std::size_t, std::size_t, double>> es{{5, 6, 1.0}, {0, 1, 8.0}, {6, 5, 2.0}};
+    addEdges(es, g);
+    assert(numEdges(g) == 6 && g[*edge(0, 1, g)] == 1.5 && g[*edge(6, 5, g)] == 2.0);
+
+    MemoryUsage usage = memoryUsage(g);
+    assert(usage.properties == 104 * sizeof(int) + 104 * 104 * sizeof(double));
+    shrinkToFit(g);
+    assert(memoryUsage(g).slack == 0 && g[*edge(5, 6, g)] == 1.0);
+    std::cout << "matrix properties: ok\n";
+}
+
+
+/**
+ * @brief Tests TiledMatrix against a set of edges clustered around the diagonal, and
+ * 			bfsLevels() and transitiveClosure() against reference results.
+ */
+void testTiledMatrix() {
+    static_assert(IncidenceGraph<TiledMatrix> && EdgeListGraph<TiledMatrix> && MutableGraph<TiledMatrix>);
+    // edges cluster around the diagonal, with a few long ones
+    const std::size_t n = 500;
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<std::size_t> pick(0, n - 1), near(0, 40);
+    std::set<std::pair<std::size_t, std::size_t>> es;
+    for(std::size_t i = 0; i < 1500; ++i) {
+        std::size_t a = pick(rng);
+        es.insert({a, std::min(n - 1, a + near(rng))});
+    }
+    for(std::size_t i = 0; i < 20; ++i) es.insert({pick(rng), pick(rng)});
+
+    AdjacencyList<graph::tags::Directed> ref(n);
+    for(auto [a, b] : es) addEdge(a, b, ref);
+    TiledMatrix g(ref);
+    assert(numVertices(g) == n && numEdges(g) == es.size());
+    for(auto v : vertices(g)) {
+        assert(outDegree(v, g) == outDegree(v, ref));
+        std::size_t prev = 0, count = 0;
+        for(auto e : outEdges(v, g)) {
+            assert(source(e, g) == v && es.count({v, target(e, g)}));
+            assert(count++ == 0 || target(e, g) > prev);
+            prev = target(e, g);
+        }
+    }
+    std::vector<std::pair<std::size_t, std::size_t>> listed;
+    for(auto e : edges(g)) listed.emplace_back(source(e, g), target(e, g));
+    assert(std::equal(listed.begin(), listed.end(), es.begin(), es.end()));
+    for(std::size_t i = 0; i < 1000; ++i) {
+        std::size_t a = pick(rng), b = pick(rng);
+        assert(edge(a, b, g).has_value() == (es.count({a, b}) == 1));
+    }
+
+    // far fewer tiles than a dense matrix
+    assert(memoryUsage(g).edgeArray < n * n / 8 / 2);
+
+    // tile-level BFS agrees with a queue based BFS
+    std::vector<std::size_t> expected(n, TiledMatrix::unreachable);
+    std::vector<std::size_t> queue{0};
+    expected[0] = 0;
+    for(std::size_t i = 0; i < queue.size(); ++i)
+        for(auto e : outEdges(queue[i], ref))
+            if(expected[target(e, ref)] == TiledMatrix::unreachable) {
+                expected[target(e, ref)] = expected[queue[i]] + 1;
+                queue.push_back(target(e, ref));
+            }
+    assert(bfsLevels(g, 0) == expected);
+
+    // the closure holds exactly the pairs reachable by at least one edge
+    TiledMatrix closure = transitiveClosure(g);
+    std::size_t pairs = 0;
+    for(auto u : vertices(g)) {
+        std::vector<bool> reach(n);
+        std::vector<std::size_t> stack;
+        for(auto e : outEdges(u, g)) stack.push_back(target(e, g));
+        while(!stack.empty()) {
+            std::size_t v = stack.back();
+            stack.pop_back();
+            if(reach[v]) continue;
+            reach[v] = true;
+            for(auto e : outEdges(v, g)) stack.push_back(target(e, g));
+        }
+        assert(outDegree(u, closure) == (std::size_t)std::count(reach.begin(), reach.end(), true));
+        for(auto e : outEdges(u, closure)) assert(reach[target(e, closure)]);
+        pairs += outDegree(u, closure);
+    }
+    assert(numEdges(closure) == pairs);
+
+    // grows a vertex at a time, re-adding an edge is a no-op
+    TiledMatrix h;
+    for(std::size_t v = 0; v < 130; ++v) assert(addVertex(h) == v);
+    addEdge(129, 0, h);
+    addEdge(129, 0, h);
+    addEdges(std::vector<std::pair<std::size_t, std::size_t>>{{0, 64}, {64, 129}}, h);
+    assert(numEdges(h) == 3 && edge(129, 0, h) && bfsLevels(h, 0)[129] == 2);
+    std::cout << "tiled matrix: ok\n";
+}
+
+
+/**
+ * @brief Tests that the generators only depend on their seed, and the edge counts, ranges and
+ * 			shapes of rmat(), erdosRenyi(), barabasiAlbert(), the grids and randomDag().
+ */
+void testGenerators() {
+    // the output only depends on the seed, not on the number of threads
+    auto all = [](std::size_t threads) {
+        setNumThreads(threads);
+        return std::vector<GeneratedEdges>{rmat(12, 8, 1), erdosRenyi(3000, 20000, 2),
+                                           barabasiAlbert(5000, 4, 3), randomDag(4000, 30000, 4),
+                                           grid3d(20, 20, 20, true)};
+    };
+    auto single = all(1), multi = all(4);
+    setNumThreads(0);
+    for(std::size_t i = 0; i < single.size(); ++i)
+        assert(single[i].n == multi[i].n && single[i].edges == multi[i].edges);
+
+    const GeneratedEdges &r = single[0];
+    assert(r.n == 4096 && r.edges.size() == 8 * 4096);
+    std::vector<std::size_t> degree(r.n);
+    for(auto [u, v] : r.edges) {
+        assert(u < r.n && v < r.n);
+        ++degree[u];
+    }
+    // R-MAT is skewed towards the low vertex ids
+    assert(degree[0] > 20 * 8);
+
+    const GeneratedEdges &er = single[1];
+    std::set<std::pair<std::size_t, std::size_t>> distinct(er.edges.begin(), er.edges.end());
+    assert(er.edges.size() == 20000 && distinct.size() == 20000);
+    for(auto [u, v] : er.edges) assert(u != v && u < 3000 && v < 3000);
+
+    const GeneratedEdges &ba = single[2];
+    std::vector<std::size_t> inDeg(ba.n);
+    assert(ba.edges.size() == 4999 * 4);
+    for(auto [u, v] : ba.edges) {
+        assert(v < u);
+        ++inDeg[v];
+    }
+    // preferential attachment gives hubs far above the average in-degree of 4
+    assert(*std::max_element(inDeg.begin(), inDeg.end()) > 100);
+
+    auto dag = makeGraph<AdjacencyList<graph::tags::Directed>>(single[3]);
+    assert(numEdges(dag) == 30000);
+    std::vector<std::size_t> order;
+    topoSort(dag, std::back_inserter(order));
+    assert(order.size() == 4000);
+
+    // every vertex of a periodic grid has two neighbours per axis
+    const GeneratedEdges &torus = single[4];
+    assert(torus.edges.size() == 8000 * 6);
+    GeneratedEdges g2 = grid2d(3, 4), g3 = grid3d(2, 3, 4);
+    assert(g2.edges.size() == 2 * (3 * 3 + 2 * 4) && grid2d(3, 4, true).edges.size() == 12 * 4);
+    assert(g3.edges.size() == 2 * (1 * 3 * 4 + 2 * 2 * 4 + 2 * 3 * 3));
+    for(auto [u, v] : g2.edges) assert(std::find(g2.edges.begin(), g2.edges.end(), std::make_pair(v, u)) != g2.edges.end());
+
+    // straight into CompressedGraph and the binary format, matching a built graph
+    auto list = makeGraph<AdjacencyList<graph::tags::Directed>>(r);
+    CompressedGraph direct(r.n, r.edges), viaList(list);
+    assert(numEdges(direct) == numEdges(viaList));
+    for(auto v : vertices(list)) {
+        auto a = outEdges(v, direct), b = outEdges(v, viaList);
+        assert(std::equal(a.begin(), a.end(), b.begin(), b.end(),
+            [&](auto x, auto y) { return target(x, direct) == target(y, viaList); }));
+    }
+    const auto tmp = std::filesystem::temp_directory_path();
+    const auto fromPairs = (tmp / "graph_generated_pairs.bin").string(), fromGraph = (tmp / "graph_generated_list.bin").string();
+    writeBinaryAdjacency(r.n, r.edges, fromPairs);
+    writeBinaryAdjacency(list, fromGraph);
+    std::ifstream a(fromPairs, std::ios::binary), b(fromGraph, std::ios::binary);
+    assert(std::equal(std::istreambuf_iterator<char>(a), std::istreambuf_iterator<char>(),
+                      std::istreambuf_iterator<char>(b), std::istreambuf_iterator<char>()));
+    std::filesystem::remove(fromPairs);
+    std::filesystem::remove(fromGraph);
+
+    // too few vertices for the requested edges is an error, not out-of-range ids
+    for(std::size_t n : {0, 1}) {
+        bool thrown = false;
+        try { randomDag(n, 1, 5); } catch(const std::invalid_argument&) { thrown = true; }
+        assert(thrown && randomDag(n, 0, 5).edges.empty());
+        thrown = false;
+        try { erdosRenyi(n, 1, 5); } catch(const std::invalid_argument&) { thrown = true; }
+        assert(thrown);
+    }
+    std::cout << "generators: ok\n";
+}
+
+
+/**
+ * @brief Tests PerfCounters, which read zero if perf_event_open is unavailable, and the
+ * 			nesting, worker threads and report of ScopedPhase.
+ */
+void testPerfCounters() {
+    // perf_event_open may be unavailable (e.g. in containers), then the counters read zero
+    PerfCounters counters;
+    CounterValues before = counters.read();
+    auto g = makeGraph<AdjacencyList<graph::tags::Directed>>(randomDag(2000, 10000, 5));
+    CounterValues after = counters.read();
+    if(counters.available(PerfCounters::Instructions)) assert(after.instructions > before.instructions);
+    else assert(after.instructions == 0);
+    // differences of scaled readings saturate instead of wrapping around
+    CounterValues lower{5, 10, 0, 0}, higher{7, 8, 1, 0};
+    CounterValues diff = lower - higher;
+    assert(diff.cycles == 0 && diff.instructions == 2 && diff.llcMisses == 0);
+
+    resetPhaseReport();
+    {
+        ScopedPhase outer("outer");
+        for(int i = 0; i < 3; ++i) {
+            ScopedPhase inner("inner");
+            std::vector<std::size_t> order;
+            topoSort(g, std::back_inserter(order));
+            assert(order.size() == 2000);
+        }
+    }
+    // built with GRAPH_ENABLE_PERF_COUNTERS the library adds phases of its own, e.g. "topoSort",
+    // so the expected ones are looked up by name
+    auto position = [](const std::vector<PhaseStats> &report, const std::string &name) {
+        auto it = std::find_if(report.begin(), report.end(), [&](const PhaseStats &p) { return p.name == name; });
+        assert(it != report.end());
+        return static_cast<std::size_t>(it - report.begin());
+    };
+    // phases are listed in order of completion, so the inner one comes first
+    auto report = phaseReport();
+    const std::size_t innerPos = position(report, "inner"), outerPos = position(report, "outer");
+    assert(innerPos < outerPos);
+    const PhaseStats &inner = report[innerPos], &outer = report[outerPos];
+    assert(outer.calls == 1 && inner.calls == 3);
+    assert(outer.nanoseconds >= inner.nanoseconds && inner.nanoseconds > 0);
+    assert(outer.counters.instructions >= inner.counters.instructions);
+
+    // another thread working for a phase adds its counts to it and the phases enclosing it
+    resetPhaseReport();
+    CounterValues workerCounts;
+    {
+        ScopedPhase outerPhase("outer");
+        ScopedPhase parallelPhase("parallel");
+        assert(ScopedPhase::current() == &parallelPhase);
+        std::thread([&] {
+            PhaseWorker counted(&parallelPhase);
+            assert(ScopedPhase::current() == nullptr);
+            const CounterValues start = graph::detail::threadCounters().read();
+            std::vector<std::size_t> order;
+            topoSort(g, std::back_inserter(order));
+            workerCounts = graph::detail::threadCounters().read() - start;
+        }).join();
+    }
+    assert(ScopedPhase::current() == nullptr);
+    auto parallelReport = phaseReport();
+    const PhaseStats &parallelStats = parallelReport[position(parallelReport, "parallel")];
+    const PhaseStats &enclosing = parallelReport[position(parallelReport, "outer")];
+    assert(parallelStats.calls == 1 && parallelStats.counters.instructions >= workerCounts.instructions);
+    assert(enclosing.counters.instructions >= parallelStats.counters.instructions);
+    std::ostringstream table;
+    printPhaseReport(table);
+    assert(table.str().find("parallel") != std::string::npos);
+    resetPhaseReport();
+    assert(phaseReport().empty());
+    std::cout << "perf counters" << (counters.available() ? "" : " (unavailable)") << ": ok\n";
+}
+
+
+/**
+ * @brief Tests StatsVisitor on dfs(), bfs() and dijkstra(), and stacked on the topological
+ * 			sort with composeVisitors().
+ */
+void testTraversalStats() {
+    using G = AdjacencyList<graph::tags::Directed>;
+    // 0 -> 1 -> 2 -> 0 is a cycle, 0 -> 3 -> 2 a forward or cross edge, 4 an isolated root
+    G g(5);
+    addEdges(std::vector<std::pair<std::size_t, std::size_t>>{{0, 1}, {1, 2}, {2, 0}, {0, 3}, {3, 2}}, g);
+    TraversalStats dfsStats;
+    dfs(g, StatsVisitor(dfsStats));
+    assert(dfsStats.roots == 2 && dfsStats.verticesDiscovered == 5 && dfsStats.verticesFinished == 5);
+    assert(dfsStats.edgesExamined == 5 && dfsStats.treeEdges == 3);
+    assert(dfsStats.backEdges == 1 && dfsStats.forwardOrCrossEdges == 1);
+    assert(dfsStats.frontier == 0 && dfsStats.maxFrontier == 3);
+
+    // the stats ride along with the topological sort in the same traversal
+    auto dag = makeGraph<G>(randomDag(500, 3000, 11));
+    std::vector<std::size_t> order, expected;
+    topoSort(dag, std::back_inserter(expected));
+    TraversalStats topoStats;
+    dfs(dag, composeVisitors(StatsVisitor(topoStats), TopoVisitor(std::back_inserter(order))));
+    assert(order == expected);
+    assert(topoStats.verticesDiscovered == 500 && topoStats.edgesExamined == numEdges(dag));
+    assert(topoStats.backEdges == 0 && topoStats.treeEdges == 500 - topoStats.roots);
+
+    // bfs on a 20 x 30 grid: the frontier is the queue, at most a diagonal plus its neighbours
+    GeneratedEdges grid = grid2d(20, 30);
+    auto gridGraph = makeGraph<G>(grid);
+    TraversalStats bfsStats;
+    bfs(gridGraph, 0, StatsVisitor(bfsStats));
+    assert(bfsStats.roots == 1 && bfsStats.verticesDiscovered == 600 && bfsStats.verticesFinished == 600);
+    assert(bfsStats.edgesExamined == grid.edges.size() && bfsStats.treeEdges == 599);
+    assert(bfsStats.nonTreeEdges == grid.edges.size() - 599 && bfsStats.backEdges == 0);
+    assert(bfsStats.frontier == 0 && bfsStats.maxFrontier >= 20 && bfsStats.maxFrontier <= 42);
+    GenerationVisitedSet visited(600);
+    TraversalStats reused;
+    bfs(gridGraph, 0, StatsVisitor(reused), visited);
+    visited.clear();
+    bfs(gridGraph, 599, StatsVisitor(reused), visited);
+    assert(reused.roots == 2 && reused.verticesDiscovered == 1200);
+
+    // dijkstra with unit weights agrees with the levels of a bfs
+    GeneratedEdges er = erdosRenyi(300, 900, 3);
+    auto erGraph = makeGraph<G>(er);
+    TraversalStats sssp;
+    auto dist = dijkstra(erGraph, 0, [](const auto&) { return std::size_t(1); }, StatsVisitor(sssp));
+    std::vector<std::size_t> levels = bfsLevels(TiledMatrix(erGraph), 0);
+    std::size_t reached = 0;
+    for(std::size_t v = 0; v < 300; ++v) {
+        if(levels[v] == TiledMatrix::unreachable) assert(dist[v] == infiniteDistance<std::size_t>());
+        else { assert(dist[v] == levels[v]); ++reached; }
+    }
+    assert(sssp.verticesDiscovered == reached && sssp.verticesFinished == reached);
+    assert(sssp.edgesRelaxed >= reached - 1 && sssp.frontier == 0);
+    // without a visitor the result is the same
+    assert(dijkstra(erGraph, 0, [](const auto&) { return std::size_t(1); }) == dist);
+    // a caller-owned distance map, reset in O(1) between searches
+    GenerationPropertyMap<std::size_t> distMap(300, infiniteDistance<std::size_t>());
+    for(int run = 0; run < 2; ++run) {
+        distMap.clear();
+        dijkstra(erGraph, 0, [](const auto&) { return std::size_t(1); }, DijkstraNullVisitor{}, distMap);
+        for(std::size_t v = 0; v < 300; ++v) assert(get(distMap, v) == dist[v]);
+    }
+    std::cout << "traversal stats: ok\n";
+}
+
+
+/**
+ * @brief Tests the trace buffers with nested scopes and several threads, the wrap-around of a
+ * 			full buffer and the Chrome trace JSON written to a stream and a file.
+ */
+void testTrace() {
+    clearTrace();
+    {
+        ScopedTrace outer("outer");
+        ScopedTrace inner("in\"ner");
+    }
+    std::vector<std::thread> threads;
+    for(int t = 0; t < 2; ++t) threads.emplace_back([] { ScopedTrace worker("worker"); });
+    for(auto &t : threads) t.join();
+
+    auto own = graph::detail::threadTraceBuffer().events();
+    assert(own.size() == 4);
+    assert(own[0].begin && std::string(own[0].name) == "outer" && own[1].begin);
+    assert(!own[2].begin && std::string(own[2].name) == "in\"ner" && !own[3].begin);
+    assert(own[0].nanoseconds <= own[1].nanoseconds && own[2].nanoseconds <= own[3].nanoseconds);
+
+    std::ostringstream json;
+    writeChromeTrace(json);
+    const std::string trace = json.str();
+    auto count = [&](const std::string &needle) {
+        std::size_t k = 0;
+        for(auto pos = trace.find(needle); pos != std::string::npos; pos = trace.find(needle, pos + 1)) ++k;
+        return k;
+    };
+    assert(trace.find("\"traceEvents\"") != std::string::npos);
+    assert(count("\"ph\": \"B\"") == 4 && count("\"ph\": \"E\"") == 4);
+    assert(count("\"name\": \"worker\"") == 4 && count("\"name\": \"in\\\"ner\"") == 2);
+
+    // threads started one after another reuse the buffer of the previous one
+    const std::size_t buffers = graph::detail::traceRegistry().snapshot().size();
+    for(int t = 0; t < 20; ++t) std::thread([] { ScopedTrace churn("churn"); }).join();
+    assert(graph::detail::traceRegistry().snapshot().size() <= buffers + 1);
+
+    // a full ring keeps the newest events and the dump drops ends whose begin was overwritten
+    clearTrace();
+    {
+        ScopedTrace open("open");
+        for(std::size_t i = 0; i < TraceBuffer::capacity; ++i) ScopedTrace step("step");
+    }
+    own = graph::detail::threadTraceBuffer().events();
+    assert(own.size() == TraceBuffer::capacity && !own.back().begin && std::string(own.back().name) == "open");
+    assert(!own.front().begin);
+    std::ostringstream wrapped;
+    writeChromeTrace(wrapped);
+    assert(wrapped.str().find("\"open\"") == std::string::npos);
+
+    const std::string path = (std::filesystem::temp_directory_path() / "graph_trace_test.json").string();
+    writeChromeTrace(path);
+    std::ifstream in(path);
+    std::string first;
+    std::getline(in, first);
+    assert(first.rfind("{\"displayTimeUnit\"", 0) == 0);
+    std::filesystem::remove(path);
+    // dumps while another thread keeps wrapping its buffer only see whole events in order
+    std::atomic<bool> stop{false};
+    std::atomic<const TraceBuffer*> spinning{nullptr};
+    std::thread writer([&] {
+        spinning = &graph::detail::threadTraceBuffer();
+        while(!stop) ScopedTrace spin("spin");
+    });
+    while(!spinning) std::this_thread::yield();
+    for(int dump = 0; dump < 50; ++dump) {
+        auto evs = spinning.load()->events();
+        assert(evs.size() <= TraceBuffer::capacity);
+        for(std::size_t i = 1; i < evs.size(); ++i) {
+            assert(std::string(evs[i].name) == "spin" && evs[i].begin != evs[i - 1].begin);
+            assert(evs[i].nanoseconds >= evs[i - 1].nanoseconds);
+        }
+        std::ostringstream concurrent;
+        writeChromeTrace(concurrent);
+    }
+    stop = true;
+    writer.join();
+
+    clearTrace();
+    std::ostringstream empty;
+    writeChromeTrace(empty);
+    assert(empty.str().find("\"ph\"") == std::string::npos);
+    std::cout << "trace: ok\n";
+}